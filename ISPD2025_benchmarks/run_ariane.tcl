@@ -14,9 +14,7 @@ proc load_design {libs lefs design netlist def sdc} {
   }
   puts "success:readlib"
 
-  foreach lef $lefs {
-    sca::read_lef $lef
-  }
+  sca::read_lef $lefs
   puts "success:readlef"
 
   sca::read_def $def
@@ -55,13 +55,406 @@ BEGIN_LEFDEF_PARSER_NAMESPACE
 
 #include "def_parser.hpp"
 
+// Keywords of the DEF language. The lexer looks them up through a perfect
+// hash built at compile time. Matching ignores case, so tokens are looked
+// up as they are read, without an upper case copy.
+struct defKeyword
+{
+  const char* name;
+  int token;
+};
+
+static constexpr defKeyword defKeywords[] = {
+    {"ALIGN", K_ALIGN},
+    {"ANALOG", K_ANALOG},
+    {"ANTENNAMODEL", K_ANTENNAMODEL},
+    {"ANTENNAPINGATEAREA", K_ANTENNAPINGATEAREA},
+    {"ANTENNAPINDIFFAREA", K_ANTENNAPINDIFFAREA},
+    {"ANTENNAPINMAXAREACAR", K_ANTENNAPINMAXAREACAR},
+    {"ANTENNAPINMAXCUTCAR", K_ANTENNAPINMAXCUTCAR},
+    {"ANTENNAPINMAXSIDEAREACAR", K_ANTENNAPINMAXSIDEAREACAR},
+    {"ANTENNAPINPARTIALCUTAREA", K_ANTENNAPINPARTIALCUTAREA},
+    {"ANTENNAPINPARTIALMETALAREA", K_ANTENNAPINPARTIALMETALAREA},
+    {"ANTENNAPINPARTIALMETALSIDEAREA", K_ANTENNAPINPARTIALMETALSIDEAREA},
+    {"ARRAY", K_ARRAY},
+    {"ASSERTIONS", K_ASSERTIONS},
+    {"BALANCED", K_BALANCED},
+    {"BEGINEXT", K_BEGINEXT},
+    {"BLOCKAGES", K_BLOCKAGES},
+    {"BLOCKAGEWIRE", K_BLOCKAGEWIRE},
+    {"BLOCKRING", K_BLOCKRING},
+    {"BLOCKWIRE", K_BLOCKWIRE},
+    {"BOTTOMLEFT", K_BOTTOMLEFT},
+    {"BUSBITCHARS", K_BUSBITCHARS},
+    {"BY", K_BY},
+    {"CANNOTOCCUPY", K_CANNOTOCCUPY},
+    {"CANPLACE", K_CANPLACE},
+    {"CAPACITANCE", K_CAPACITANCE},
+    {"CLOCK", K_CLOCK},
+    {"COMMONSCANPINS", K_COMMONSCANPINS},
+    {"COMPONENT", K_COMPONENT},
+    {"COMPONENTPIN", K_COMPONENTPIN},
+    {"COMPONENTS", K_COMPS},
+    {"COMPONENTMASKSHIFT", K_COMPSMASKSHIFT},
+    {"CONSTRAINTS", K_CONSTRAINTS},
+    {"COREWIRE", K_COREWIRE},
+    {"COVER", K_COVER},
+    {"CUTSIZE", K_CUTSIZE},
+    {"CUTSPACING", K_CUTSPACING},
+    {"DEFAULTCAP", K_DEFAULTCAP},
+    {"DESIGN", K_DESIGN},
+    {"DESIGNRULEWIDTH", K_DESIGNRULEWIDTH},
+    {"DIAGWIDTH", K_DIAGWIDTH},
+    {"DIEAREA", K_DIEAREA},
+    {"DIFF", K_DIFF},
+    {"DIRECTION", K_DIRECTION},
+    {"DIST", K_DIST},
+    {"DISTANCE", K_DISTANCE},
+    {"DIVIDERCHAR", K_DIVIDERCHAR},
+    {"DO", K_DO},
+    {"DRCFILL", K_DRCFILL},
+    {"DRIVECELL", K_DRIVECELL},
+    {"E", K_E},
+    {"EEQMASTER", K_EEQMASTER},
+    {"ENCLOSURE", K_ENCLOSURE},
+    {"END", K_END},
+    {"ENDEXT", K_ENDEXT},
+    {"EQUAL", K_EQUAL},
+    {"EXCEPTPGNET", K_EXCEPTPGNET},
+    {"ESTCAP", K_ESTCAP},
+    {"FALL", K_FALL},
+    {"FALLMAX", K_FALLMAX},
+    {"FALLMIN", K_FALLMIN},
+    {"FE", K_FE},
+    {"FENCE", K_FENCE},
+    {"FILLS", K_FILLS},
+    {"FILLWIRE", K_FILLWIRE},
+    {"FILLWIREOPC", K_FILLWIREOPC},
+    {"FIXED", K_FIXED},
+    {"FIXEDBUMP", K_FIXEDBUMP},
+    {"FLOATING", K_FLOATING},
+    {"FLOORPLANCONSTRAINTS", K_FPC},
+    {"FN", K_FN},
+    {"FOLLOWPIN", K_FOLLOWPIN},
+    {"FOREIGN", K_FOREIGN},
+    {"FREQUENCY", K_FREQUENCY},
+    {"FROMCLOCKPIN", K_FROMCLOCKPIN},
+    {"FROMCOMPPIN", K_FROMCOMPPIN},
+    {"FROMIOPIN", K_FROMIOPIN},
+    {"FROMPIN", K_FROMPIN},
+    {"FS", K_FS},
+    {"FW", K_FW},
+    {"GCELLGRID", K_GCELLGRID},
+    {"GENERATE", K_COMP_GEN},
+    {"GUIDE", K_GUIDE},
+    {"GROUND", K_GROUND},
+    {"GROUNDSENSITIVITY", K_GROUNDSENSITIVITY},
+    {"GROUP", K_GROUP},
+    {"GROUPS", K_GROUPS},
+    {"FLOORPLAN", K_FLOORPLAN},
+    {"HALO", K_HALO},
+    {"HARDSPACING", K_HARDSPACING},
+    {"HISTORY", K_HISTORY},
+    {"HOLDRISE", K_HOLDRISE},
+    {"HOLDFALL", K_HOLDFALL},
+    {"HORIZONTAL", K_HORIZONTAL},
+    {"IN", K_IN},
+    {"INTEGER", K_INTEGER},
+    {"IOTIMINGS", K_IOTIMINGS},
+    {"IOWIRE", K_IOWIRE},
+    {"LAYER", K_LAYER},
+    {"LAYERS", K_LAYERS},
+    {"MASK", K_MASK},
+    {"MASKSHIFT", K_MASKSHIFT},
+    {"MAX", K_MAX},
+    {"MAXBITS", K_MAXBITS},
+    {"MAXDIST", K_MAXDIST},
+    {"MAXHALFPERIMETER", K_MAXHALFPERIMETER},
+    {"MAXX", K_MAXX},
+    {"MAXY", K_MAXY},
+    {"MICRONS", K_MICRONS},
+    {"MIN", K_MIN},
+    {"MINCUTS", K_MINCUTS},
+    {"MINPINS", K_MINPINS},
+    {"MUSTJOIN", K_MUSTJOIN},
+    {"N", K_N},
+    {"NAMESCASESENSITIVE", K_NAMESCASESENSITIVE},
+    {"NAMEMAPSTRING", K_NAMEMAPSTRING},
+    {"NET", K_NET},
+    {"NETEXPR", K_NETEXPR},
+    {"NETS", K_NETS},
+    {"NETLIST", K_NETLIST},
+    {"NEW", K_NEW},
+    {"NONDEFAULTRULE", K_NONDEFAULTRULE},
+    {"NONDEFAULTRULES", K_NONDEFAULTRULES},
+    {"NOSHIELD", K_NOSHIELD},
+    {"ON", K_ON},
+    {"OFF", K_OFF},
+    {"OFFSET", K_OFFSET},
+    {"OPC", K_OPC},
+    {"ORDERED", K_ORDERED},
+    {"ORIGIN", K_ORIGIN},
+    {"ORIGINAL", K_ORIGINAL},
+    {"OUT", K_OUT},
+    {"OXIDE1", K_OXIDE1},
+    {"OXIDE2", K_OXIDE2},
+    {"OXIDE3", K_OXIDE3},
+    {"OXIDE4", K_OXIDE4},
+    {"OXIDE5", K_OXIDE5},
+    {"OXIDE6", K_OXIDE6},
+    {"OXIDE7", K_OXIDE7},
+    {"OXIDE8", K_OXIDE8},
+    {"OXIDE9", K_OXIDE9},
+    {"OXIDE10", K_OXIDE10},
+    {"OXIDE11", K_OXIDE11},
+    {"OXIDE12", K_OXIDE12},
+    {"OXIDE13", K_OXIDE13},
+    {"OXIDE14", K_OXIDE14},
+    {"OXIDE15", K_OXIDE15},
+    {"OXIDE16", K_OXIDE16},
+    {"OXIDE17", K_OXIDE17},
+    {"OXIDE18", K_OXIDE18},
+    {"OXIDE19", K_OXIDE19},
+    {"OXIDE20", K_OXIDE20},
+    {"OXIDE21", K_OXIDE21},
+    {"OXIDE22", K_OXIDE22},
+    {"OXIDE23", K_OXIDE23},
+    {"OXIDE24", K_OXIDE24},
+    {"OXIDE25", K_OXIDE25},
+    {"OXIDE26", K_OXIDE26},
+    {"OXIDE27", K_OXIDE27},
+    {"OXIDE28", K_OXIDE28},
+    {"OXIDE29", K_OXIDE29},
+    {"OXIDE30", K_OXIDE30},
+    {"OXIDE31", K_OXIDE31},
+    {"OXIDE32", K_OXIDE32},
+    {"PADRING", K_PADRING},
+    {"PARTIAL", K_PARTIAL},
+    {"PARTITION", K_PARTITION},
+    {"PARALLEL", K_PARALLEL},
+    {"PARTITIONS", K_PARTITIONS},
+    {"PATH", K_PATH},
+    {"PATTERN", K_PATTERN},
+    {"PATTERNNAME", K_PATTERNNAME},
+    {"PIN", K_PIN},
+    {"PINPROPERTIES", K_PINPROPERTIES},
+    {"PINS", K_PINS},
+    {"PLACED", K_PLACED},
+    {"PLACEMENT", K_PLACEMENT},
+    {"POLYGON", K_POLYGON},
+    {"PORT", K_PORT},
+    {"POWER", K_POWER},
+    {"PROPERTY", K_PROPERTY},
+    {"PROPERTYDEFINITIONS", K_PROPERTYDEFINITIONS},
+    {"PUSHDOWN", K_PUSHDOWN},
+    {"RANGE", K_RANGE},
+    {"REAL", K_REAL},
+    {"RECT", K_RECT},
+    {"REENTRANTPATHS", K_REENTRANTPATHS},
+    {"REGION", K_REGION},
+    {"REGIONS", K_REGIONS},
+    {"RESET", K_RESET},
+    {"RING", K_RING},
+    {"RISE", K_RISE},
+    {"RISEMAX", K_RISEMAX},
+    {"RISEMIN", K_RISEMIN},
+    {"ROUTED", K_ROUTED},
+    {"ROUTEHALO", K_ROUTEHALO},
+    {"ROW", K_ROW},
+    {"ROWCOL", K_ROWCOL},
+    {"ROWS", K_ROWS},
+    {"S", K_S},
+    {"SAMEMASK", K_SAMEMASK},
+    {"SCAN", K_SCAN},
+    {"SCANCHAINS", K_SCANCHAINS},
+    {"SETUPFALL", K_SETUPFALL},
+    {"SETUPRISE", K_SETUPRISE},
+    {"SHAPE", K_SHAPE},
+    {"SHIELD", K_SHIELD},
+    {"SHIELDNET", K_SHIELDNET},
+    {"SIGNAL", K_SIGNAL},
+    {"SITE", K_SITE},
+    {"SLEWRATE", K_SLEWRATE},
+    {"SLOTS", K_SLOTS},
+    {"SOFT", K_SOFT},
+    {"SOURCE", K_SOURCE},
+    {"SPACING", K_SPACING},
+    {"SPECIAL", K_SPECIAL},
+    {"SPECIALNET", K_SNET},
+    {"SPECIALNETS", K_SNETS},
+    {"START", K_START},
+    {"STEINER", K_STEINER},
+    {"STEP", K_STEP},
+    {"STOP", K_STOP},
+    {"STRING", K_STRING},
+    {"STRIPE", K_STRIPE},
+    {"STYLE", K_STYLE},
+    {"STYLES", K_STYLES},
+    {"SUBNET", K_SUBNET},
+    {"SUM", K_SUM},
+    {"SUPPLYSENSITIVITY", K_SUPPLYSENSITIVITY},
+    {"SYNTHESIZED", K_SYNTHESIZED},
+    {"TAPER", K_TAPER},
+    {"TAPERRULE", K_TAPERRULE},
+    {"TECHNOLOGY", K_TECH},
+    {"TEST", K_TEST},
+    {"TIEOFF", K_TIEOFF},
+    {"TIMING", K_TIMING},
+    {"TIMINGDISABLES", K_TIMINGDISABLES},
+    {"TOCLOCKPIN", K_TOCLOCKPIN},
+    {"TOCOMPPIN", K_TOCOMPPIN},
+    {"TOIOPIN", K_TOIOPIN},
+    {"TOPIN", K_TOPIN},
+    {"TOPRIGHT", K_TOPRIGHT},
+    {"TRACKS", K_TRACKS},
+    {"TRUNK", K_TRUNK},
+    {"TURNOFF", K_TURNOFF},
+    {"TYPE", K_TYPE},
+    {"UNITS", K_UNITS},
+    {"UNPLACED", K_UNPLACED},
+    {"USE", K_USE},
+    {"USER", K_USER},
+    {"VARIABLE", K_VARIABLE},
+    {"VERSION", K_VERSION},
+    {"VERTICAL", K_VERTICAL},
+    {"VIA", K_VIA},
+    {"VIARULE", K_VIARULE},
+    {"VIAS", K_VIAS},
+    {"VIRTUAL", K_VIRTUAL},
+    {"VOLTAGE", K_VOLTAGE},
+    {"VPIN", K_VPIN},
+    {"W", K_W},
+    {"WEIGHT", K_WEIGHT},
+    {"WIDTH", K_WIDTH},
+    {"WIRECAP", K_WIRECAP},
+    {"WIREEXT", K_WIREEXT},
+    {"WIREDLOGIC", K_WIREDLOGIC},
+    {"X", K_X},
+    {"XTALK", K_XTALK},
+    {"Y", K_Y},
+};
+
+static constexpr int defNumKeywords
+    = sizeof(defKeywords) / sizeof(defKeywords[0]);
+static constexpr unsigned defKeywordBuckets = 256;
+static constexpr unsigned defKeywordSlots = 1024;
+
+static constexpr unsigned defUpper(char c)
+{
+  return (c >= 'a' && c <= 'z') ? c - 'a' + 'A' : (unsigned char) c;
+}
+
+// FNV-1a of the upper case name.
+static constexpr unsigned defKeywordHash(const char* name)
+{
+  unsigned hash = 2166136261u;
+  for (; *name; name++)
+    hash = (hash ^ defUpper(*name)) * 16777619u;
+  return hash;
+}
+
+static constexpr unsigned defKeywordSlot(unsigned hash, unsigned seed)
+{
+  unsigned h = hash ^ (seed * 0x9e3779b9u);
+  h = (h ^ (h >> 16)) * 0x85ebca6bu;
+  h = (h ^ (h >> 13)) * 0xc2b2ae35u;
+  return (h ^ (h >> 16)) & (defKeywordSlots - 1);
+}
+
+// The hash of a name selects a bucket, and the seed of the bucket spreads
+// its keywords over the slots.
+struct defKeywordTable
+{
+  unsigned seed[defKeywordBuckets];
+  int slot[defKeywordSlots];  // index into defKeywords, -1 if free
+};
+
+static constexpr bool defKeywordSeedFits(const defKeywordTable& table,
+                                        const unsigned* hash,
+                                        const int* members,
+                                        int numMembers,
+                                        unsigned seed)
+{
+  for (int i = 0; i < numMembers; i++) {
+    unsigned slot = defKeywordSlot(hash[members[i]], seed);
+    if (table.slot[slot] >= 0)
+      return false;
+    for (int j = 0; j < i; j++)
+      if (defKeywordSlot(hash[members[j]], seed) == slot)
+        return false;
+  }
+  return true;
+}
+
+// Hash and displace: the largest buckets are placed first, each with the
+// first seed that moves all of its keywords into distinct free slots.
+static constexpr defKeywordTable defMakeKeywordTable()
+{
+  defKeywordTable table{};
+  unsigned hash[defNumKeywords] = {};
+  int bucketSize[defKeywordBuckets] = {};
+  int maxBucketSize = 0;
+  for (int i = 0; i < defNumKeywords; i++) {
+    hash[i] = defKeywordHash(defKeywords[i].name);
+    int size = ++bucketSize[hash[i] % defKeywordBuckets];
+    if (size > maxBucketSize)
+      maxBucketSize = size;
+  }
+  for (unsigned slot = 0; slot < defKeywordSlots; slot++)
+    table.slot[slot] = -1;
+
+  int members[defNumKeywords] = {};
+  for (int size = maxBucketSize; size > 0; size--) {
+    for (unsigned bucket = 0; bucket < defKeywordBuckets; bucket++) {
+      if (bucketSize[bucket] != size)
+        continue;
+      int numMembers = 0;
+      for (int i = 0; i < defNumKeywords; i++)
+        if (hash[i] % defKeywordBuckets == bucket)
+          members[numMembers++] = i;
+      unsigned seed = 0;
+      while (!defKeywordSeedFits(table, hash, members, numMembers, seed))
+        seed++;
+      table.seed[bucket] = seed;
+      for (int i = 0; i < numMembers; i++)
+        table.slot[defKeywordSlot(hash[members[i]], seed)] = members[i];
+    }
+  }
+  return table;
+}
+
+static constexpr defKeywordTable defKeywordIndex = defMakeKeywordTable();
+
+// Index of the keyword `name` in defKeywords, -1 if it is none.
+static constexpr int defFindKeyword(const char* name)
+{
+  unsigned hash = defKeywordHash(name);
+  unsigned seed = defKeywordIndex.seed[hash % defKeywordBuckets];
+  int index = defKeywordIndex.slot[defKeywordSlot(hash, seed)];
+  if (index < 0)
+    return -1;
+  const char* keyword = defKeywords[index].name;
+  for (; *name && defUpper(*name) == (unsigned char) *keyword; name++)
+    keyword++;
+  return (*name == '\0' && *keyword == '\0') ? index : -1;
+}
+
+static constexpr bool defKeywordIndexIsPerfect()
+{
+  for (int i = 0; i < defNumKeywords; i++)
+    if (defFindKeyword(defKeywords[i].name) != i)
+      return false;
+  return true;
+}
+
+static_assert(defKeywordIndexIsPerfect(), "DEF keyword hash is not perfect");
+
 int defrData::defGetKeyword(const char* name, int* result)
 {
-  std::map<const char*, int, defCompareCStrings>::const_iterator search
-      = settings->Keyword_set.find(name);
+  int index = defFindKeyword(name);
 
-  if (search != settings->Keyword_set.end()) {
-    *result = search->second;
+  if (index >= 0) {
+    *result = defKeywords[index].token;
     return TRUE;
   }
 
@@ -110,6 +503,18 @@ void defrData::reload_buffer()
 {
   int nb = 0;
 
+  if (settings->InputBuffer) {
+    /* The whole input is in memory, so it is a single chunk. */
+    if (first_buffer && settings->InputBufferSize >= 4) {
+      first_buffer = 0;
+      buffer_start = next = settings->InputBuffer;
+      last = settings->InputBuffer + settings->InputBufferSize - 1;
+    } else {
+      next = NULL;
+    }
+    return;
+  }
+
   if (first_buffer) {
     first_buffer = 0;
     if (settings->ReadFunction) {
@@ -159,7 +564,7 @@ int defrData::GETC()
 
 void defrData::UNGETC(char ch)
 {
-  if (next <= buffer) {
+  if (next <= buffer_start) {
     defError(6111, "UNGETC: buffer access violation.");
   } else {
     *(--next) = ch;
@@ -743,9 +1148,8 @@ int defrData::sublex(YYSTYPE* pYylval)
 
     if (orient_is_keyword) {
       int result = K_N;
-      uc_array(deftoken, uc_token);
 
-      if (defGetKeyword(uc_token, &result)) {
+      if (defGetKeyword(deftoken, &result)) {
         if (K_N == result)
           return K_N;
         if (K_W == result)
@@ -777,9 +1181,8 @@ int defrData::sublex(YYSTYPE* pYylval)
     int result;
 
     History_text.resize(0);
-    uc_array(deftoken, uc_token);
 
-    if (defGetKeyword(uc_token, &result)) {
+    if (defGetKeyword(deftoken, &result)) {
       if (K_HISTORY == result) { /* history - get up to ';' */
         int c;
         int prev;
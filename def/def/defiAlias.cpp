@@ -33,7 +33,7 @@
 
 BEGIN_LEFDEF_PARSER_NAMESPACE
 
-extern defrContext defContext;
+extern thread_local defrContext defContext;
 
 class defAliasIterator
 {
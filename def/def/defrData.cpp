@@ -163,6 +163,7 @@ defrData::defrData(const defrCallbacks* pCallbacks,
       sNetWarnings(0),
       netOsnet(0),
       next(NULL),
+      buffer_start(NULL),
       rowWarnings(0),
       shieldName(NULL),
       deftokenLength(TOKEN_SIZE),
@@ -203,6 +204,7 @@ defrData::defrData(const defrCallbacks* pCallbacks,
   nlines = 1;
   last = buffer - 1;
   next = buffer;
+  buffer_start = buffer;
   first_buffer = 1;
 
   lVal = strtod("-2147483648", NULL);
@@ -498,6 +500,8 @@ defrContext::defrContext(int ownConf)
 {
 }
 
-defrContext defContext;
+// One reader per thread: each thread that calls defrInit/defrRead owns its
+// own data, settings, callbacks and session.
+thread_local defrContext defContext;
 
 END_LEFDEF_PARSER_NAMESPACE
@@ -259,6 +259,7 @@ class defrData
   int sNetWarnings;
   int netOsnet;  // net = 1 & snet = 2
   char* next;
+  char* buffer_start;  // start of the current input chunk
   int rowWarnings;
   char* shieldName;  // to hold the shieldNetName
   int deftokenLength;
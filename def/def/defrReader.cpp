@@ -53,7 +53,7 @@ BEGIN_LEFDEF_PARSER_NAMESPACE
 
 extern int defyyparse(defrData* data);
 
-extern defrContext defContext;
+extern thread_local defrContext defContext;
 
 void def_init(const char* func)
 {
@@ -2174,6 +2174,20 @@ void defrUnsetReadFunction()
   defContext.settings->ReadFunction = 0;
 }
 
+void defrSetInputBuffer(char* data, size_t size)
+{
+  DEF_INIT;
+  defContext.settings->InputBuffer = data;
+  defContext.settings->InputBufferSize = size;
+}
+
+void defrUnsetInputBuffer()
+{
+  DEF_INIT;
+  defContext.settings->InputBuffer = 0;
+  defContext.settings->InputBufferSize = 0;
+}
+
 void defrDisablePropStrProcess()
 {
   DEF_INIT;
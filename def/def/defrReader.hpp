@@ -692,6 +692,13 @@ typedef size_t (*DEFI_READ_FUNCTION)(FILE*, char*, size_t);
 extern void defrSetReadFunction(DEFI_READ_FUNCTION);
 extern void defrUnsetReadFunction();
 
+// Routine to read the whole input from memory, e.g. a memory mapped file,
+// instead of the FILE* given to defrRead. The lexer hands out characters
+// directly from the buffer and writes pushed back characters into it, so
+// it must stay valid and writable until defrRead returns.
+extern void defrSetInputBuffer(char* data, size_t size);
+extern void defrUnsetInputBuffer();
+
 // Routine to set the defrWarning.log to open as append instead for write
 // New in 5.7
 extern void defrSetOpenLogFileAppend();
@@ -41,24 +41,12 @@
 
 BEGIN_LEFDEF_PARSER_NAMESPACE
 
-struct defCompareCStrings
-{
-  bool operator()(const char* lhs, const char* rhs) const
-  {
-    return std::strcmp(lhs, rhs) < 0;
-  }
-};
-
-typedef std::map<const char*, int, defCompareCStrings> defKeywordMap;
 
 class defrSettings
 {
  public:
   defrSettings();
 
-  void init_symbol_table();
-
-  defKeywordMap Keyword_set;
 
   int defiDeltaNumberLines;
 
@@ -99,6 +87,8 @@ class defrSettings
   char CommentChar;
 
   DEFI_READ_FUNCTION ReadFunction;
+  char* InputBuffer;
+  size_t InputBufferSize;
   DEFI_LOG_FUNCTION ErrorLogFunction;
   DEFI_WARNING_LOG_FUNCTION WarningLogFunction;
   DEFI_CONTEXT_LOG_FUNCTION ContextErrorLogFunction;
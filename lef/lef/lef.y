@@ -48,6 +48,7 @@
 //   4700 - lef writer, info, lefwWrtier.cpp & lefwWriterCalls.cpp
 // 
 //   Highest message number = 4700
+%pure-parser
 
 %{
 #include <string.h>
@@ -70,6 +71,17 @@
 
 BEGIN_LEFDEF_PARSER_NAMESPACE
 
+// The parser is pure so that several threads can parse at once. The lexer
+// leaves the token value in its thread local lefyylval.
+extern thread_local YYSTYPE lefyylval;
+
+static int yylex(YYSTYPE *pYylval)
+{
+  int v = yylex();
+  *pYylval = lefyylval;
+  return v;
+}
+
 #define LYPROP_ECAP "EDGE_CAPACITANCE"
 
 #define YYINITDEPTH 10000  // pcr 640902 - initialize the yystacksize to 300 
@@ -52,7 +52,8 @@ BEGIN_LEFDEF_PARSER_NAMESPACE
 
 #include "lef_parser.hpp"
 
-extern YYSTYPE lefyylval;
+// Token value of the lexer, per thread as the reader state is.
+thread_local YYSTYPE lefyylval;
 
 inline std::string strip_case(const char* str)
 {
@@ -69,12 +70,572 @@ inline std::string strip_case(const char* str)
   return result;
 }
 
+// Keywords of the LEF language. The lexer looks them up through a perfect
+// hash built at compile time. Matching ignores case, so tokens are looked
+// up as they are read, without an upper case copy.
+struct lefKeyword
+{
+  const char* name;
+  int token;
+};
+
+static constexpr lefKeyword lefKeywords[] = {
+    {"&DEFINE", K_DEFINE},
+    {"&DEFINEB", K_DEFINEB},
+    {"&DEFINES", K_DEFINES},
+    {"&MESSAGE", K_MESSAGE},
+    {"&CREATEFILE", K_CREATEFILE},
+    {"&OPENFILE", K_OPENFILE},
+    {"&CLOSEFILE", K_CLOSEFILE},
+    {"&WARNING", K_WARNING},
+    {"&ERROR", K_ERROR},
+    {"&FATALERROR", K_FATALERROR},
+    {"ABOVE", K_ABOVE},
+    {"ABUT", K_ABUT},
+    {"ABUTMENT", K_ABUTMENT},
+    {"ACCURRENTDENSITY", K_ACCURRENTDENSITY},
+    {"ACTIVE", K_ACTIVE},
+    {"ADJACENTCUTS", K_ADJACENTCUTS},
+    {"ANALOG", K_ANALOG},
+    {"AND", K_AND},
+    {"ANTENNAAREAFACTOR", K_ANTENNAAREAFACTOR},
+    {"ANTENNAAREADIFFREDUCEPWL", K_ANTENNAAREADIFFREDUCEPWL},
+    {"ANTENNAAREAMINUSDIFF", K_ANTENNAAREAMINUSDIFF},
+    {"ANTENNAAREARATIO", K_ANTENNAAREARATIO},
+    {"ANTENNACELL", K_ANTENNACELL},
+    {"ANTENNACUMAREARATIO", K_ANTENNACUMAREARATIO},
+    {"ANTENNACUMDIFFAREARATIO", K_ANTENNACUMDIFFAREARATIO},
+    {"ANTENNACUMDIFFSIDEAREARATIO", K_ANTENNACUMDIFFSIDEAREARATIO},
+    {"ANTENNACUMROUTINGPLUSCUT", K_ANTENNACUMROUTINGPLUSCUT},
+    {"ANTENNACUMSIDEAREARATIO", K_ANTENNACUMSIDEAREARATIO},
+    {"ANTENNADIFFAREA", K_ANTENNADIFFAREA},
+    {"ANTENNADIFFAREARATIO", K_ANTENNADIFFAREARATIO},
+    {"ANTENNADIFFSIDEAREARATIO", K_ANTENNADIFFSIDEAREARATIO},
+    {"ANTENNAGATEAREA", K_ANTENNAGATEAREA},
+    {"ANTENNAGATEPLUSDIFF", K_ANTENNAGATEPLUSDIFF},
+    {"ANTENNAINOUTDIFFAREA", K_ANTENNAINOUTDIFFAREA},
+    {"ANTENNAINPUTGATEAREA", K_ANTENNAINPUTGATEAREA},
+    {"ANTENNALENGTHFACTOR", K_ANTENNALENGTHFACTOR},
+    {"ANTENNAMAXAREACAR", K_ANTENNAMAXAREACAR},
+    {"ANTENNAMAXCUTCAR", K_ANTENNAMAXCUTCAR},
+    {"ANTENNAMAXSIDEAREACAR", K_ANTENNAMAXSIDEAREACAR},
+    {"ANTENNAMETALAREA", K_ANTENNAMETALAREA},
+    {"ANTENNAMETALLENGTH", K_ANTENNAMETALLENGTH},
+    {"ANTENNAMODEL", K_ANTENNAMODEL},
+    {"ANTENNAOUTPUTDIFFAREA", K_ANTENNAOUTPUTDIFFAREA},
+    {"ANTENNAPARTIALCUTAREA", K_ANTENNAPARTIALCUTAREA},
+    {"ANTENNAPARTIALMETALAREA", K_ANTENNAPARTIALMETALAREA},
+    {"ANTENNAPARTIALMETALSIDEAREA", K_ANTENNAPARTIALMETALSIDEAREA},
+    {"ANTENNASIDEAREARATIO", K_ANTENNASIDEAREARATIO},
+    {"ANTENNASIZE", K_ANTENNASIZE},
+    {"ANTENNASIDEAREAFACTOR", K_ANTENNASIDEAREAFACTOR},
+    {"ANYEDGE", K_ANYEDGE},
+    {"AREA", K_AREA},
+    {"AREAIO", K_AREAIO},
+    {"ARRAY", K_ARRAY},
+    {"ARRAYCUTS", K_ARRAYCUTS},
+    {"ARRAYSPACING", K_ARRAYSPACING},
+    {"AVERAGE", K_AVERAGE},
+    {"BELOW", K_BELOW},
+    {"BEGINEXT", K_BEGINEXT},
+    {"BLACKBOX", K_BLACKBOX},
+    {"BLOCK", K_BLOCK},
+    {"BOTTOMLEFT", K_BOTTOMLEFT},
+    {"BOTTOMRIGHT", K_BOTTOMRIGHT},
+    {"BUMP", K_BUMP},
+    {"BUSBITCHARS", K_BUSBITCHARS},
+    {"BUFFER", K_BUFFER},
+    {"BY", K_BY},
+    {"CANNOTOCCUPY", K_CANNOTOCCUPY},
+    {"CANPLACE", K_CANPLACE},
+    {"CAPACITANCE", K_CAPACITANCE},
+    {"CAPMULTIPLIER", K_CAPMULTIPLIER},
+    {"CENTERTOCENTER", K_CENTERTOCENTER},
+    {"CLASS", K_CLASS},
+    {"CLEARANCEMEASURE", K_CLEARANCEMEASURE},
+    {"CLOCK", K_CLOCK},
+    {"CLOCKTYPE", K_CLOCKTYPE},
+    {"COLUMNMAJOR", K_COLUMNMAJOR},
+    {"CURRENTDEN", K_CURRENTDEN},
+    {"COMPONENTPIN", K_COMPONENTPIN},
+    {"CORE", K_CORE},
+    {"CORNER", K_CORNER},
+    {"CORRECTIONFACTOR", K_CORRECTIONFACTOR},
+    {"CORRECTIONTABLE", K_CORRECTIONTABLE},
+    {"COVER", K_COVER},
+    {"CPERSQDIST", K_CPERSQDIST},
+    {"CURRENT", K_CURRENT},
+    {"CURRENTSOURCE", K_CURRENTSOURCE},
+    {"CUT", K_CUT},
+    {"CUTAREA", K_CUTAREA},
+    {"CUTSIZE", K_CUTSIZE},
+    {"CUTSPACING", K_CUTSPACING},
+    {"DATA", K_DATA},
+    {"DATABASE", K_DATABASE},
+    {"DCCURRENTDENSITY", K_DCCURRENTDENSITY},
+    {"DEFAULT", K_DEFAULT},
+    {"DEFAULTCAP", K_DEFAULTCAP},
+    {"DELAY", K_DELAY},
+    {"DENSITY", K_DENSITY},
+    {"DENSITYCHECKSTEP", K_DENSITYCHECKSTEP},
+    {"DENSITYCHECKWINDOW", K_DENSITYCHECKWINDOW},
+    {"DESIGNRULEWIDTH", K_DESIGNRULEWIDTH},
+    {"DIAG45", K_DIAG45},
+    {"DIAG135", K_DIAG135},
+    {"DIAGMINEDGELENGTH", K_DIAGMINEDGELENGTH},
+    {"DIAGSPACING", K_DIAGSPACING},
+    {"DIAGPITCH", K_DIAGPITCH},
+    {"DIAGWIDTH", K_DIAGWIDTH},
+    {"DIELECTRIC", K_DIELECTRIC},
+    {"DIFFUSEONLY", K_DIFFUSEONLY},
+    {"DIRECTION", K_DIRECTION},
+    {"DIVIDERCHAR", K_DIVIDERCHAR},
+    {"DO", K_DO},
+    {"E", K_E},
+    {"EDGECAPACITANCE", K_EDGECAPACITANCE},
+    {"EDGERATE", K_EDGERATE},
+    {"EDGERATESCALEFACTOR", K_EDGERATESCALEFACTOR},
+    {"EDGERATETHRESHOLD1", K_EDGERATETHRESHOLD1},
+    {"EDGERATETHRESHOLD2", K_EDGERATETHRESHOLD2},
+    {"EEQ", K_EEQ},
+    {"ELSE", K_ELSE},
+    {"ENCLOSURE", K_ENCLOSURE},
+    {"END", K_END},
+    {"ENDEXT", K_ENDEXT},
+    {"ENDCAP", K_ENDCAP},
+    {"ENDOFLINE", K_ENDOFLINE},
+    {"ENDOFNOTCHWIDTH", K_ENDOFNOTCHWIDTH},
+    {"EUCLIDEAN", K_EUCLIDEAN},
+    {"EXCEPTEXTRACUT", K_EXCEPTEXTRACUT},
+    {"EXCEPTSAMEPGNET", K_EXCEPTSAMEPGNET},
+    {"EXCEPTPGNET", K_EXCEPTPGNET},
+    {"EXTENSION", K_EXTENSION},
+    {"FALL", K_FALL},
+    {"FALLCS", K_FALLCS},
+    {"FALLRS", K_FALLRS},
+    {"FALLSATCUR", K_FALLSATCUR},
+    {"FALLSATT1", K_FALLSATT1},
+    {"FALLSLEWLIMIT", K_FALLSLEWLIMIT},
+    {"FALLT0", K_FALLT0},
+    {"FALLTHRESH", K_FALLTHRESH},
+    {"FALLVOLTAGETHRESHOLD", K_FALLVOLTAGETHRESHOLD},
+    {"FALSE", K_FALSE},
+    {"FE", K_FE},
+    {"FEEDTHRU", K_FEEDTHRU},
+    {"FILLACTIVESPACING", K_FILLACTIVESPACING},
+    {"FIXED", K_FIXED},
+    {"FIXEDMASK", K_FIXEDMASK},
+    {"FLIP", K_FLIP},
+    {"FLOORPLAN", K_FLOORPLAN},
+    {"FN", K_FN},
+    {"FOREIGN", K_FOREIGN},
+    {"FREQUENCY", K_FREQUENCY},
+    {"FROMABOVE", K_FROMABOVE},
+    {"FROMBELOW", K_FROMBELOW},
+    {"FROMPIN", K_FROMPIN},
+    {"FUNCTION", K_FUNCTION},
+    {"FS", K_FS},
+    {"FW", K_FW},
+    {"GCELLGRID", K_GCELLGRID},
+    {"GENERATE", K_GENERATE},
+    {"GENERATED", K_GENERATED},
+    {"GENERATOR", K_GENERATOR},
+    {"GROUND", K_GROUND},
+    {"GROUNDSENSITIVITY", K_GROUNDSENSITIVITY},
+    {"HARDSPACING", K_HARDSPACING},
+    {"HEIGHT", K_HEIGHT},
+    {"HISTORY", K_HISTORY},
+    {"HOLD", K_HOLD},
+    {"HORIZONTAL", K_HORIZONTAL},
+    {"IF", K_IF},
+    {"IMPLANT", K_IMPLANT},
+    {"INFLUENCE", K_INFLUENCE},
+    {"INOUT", K_INOUT},
+    {"INOUTPINANTENNASIZE", K_INOUTPINANTENNASIZE},
+    {"INPUT", K_INPUT},
+    {"INPUTPINANTENNASIZE", K_INPUTPINANTENNASIZE},
+    {"INPUTNOISEMARGIN", K_INPUTNOISEMARGIN},
+    {"INSIDECORNER", K_INSIDECORNER},
+    {"INTEGER", K_INTEGER},
+    {"INTRINSIC", K_INTRINSIC},
+    {"INVERT", K_INVERT},
+    {"INVERTER", K_INVERTER},
+    {"IRDROP", K_IRDROP},
+    {"ITERATE", K_ITERATE},
+    {"IV_TABLES", K_IV_TABLES},
+    {"LAYER", K_LAYER},
+    {"LAYERS", K_LAYERS},
+    {"LEAKAGE", K_LEAKAGE},
+    {"LENGTH", K_LENGTH},
+    {"LENGTHSUM", K_LENGTHSUM},
+    {"LENGTHTHRESHOLD", K_LENGTHTHRESHOLD},
+    {"LEQ", K_LEQ},
+    {"LIBRARY", K_LIBRARY},
+    {"LONGARRAY", K_LONGARRAY},
+    {"MACRO", K_MACRO},
+    {"MANUFACTURINGGRID", K_MANUFACTURINGGRID},
+    {"MASTERSLICE", K_MASTERSLICE},
+    {"MASK", K_MASK},
+    {"MATCH", K_MATCH},
+    {"MAXADJACENTSLOTSPACING", K_MAXADJACENTSLOTSPACING},
+    {"MAXCOAXIALSLOTSPACING", K_MAXCOAXIALSLOTSPACING},
+    {"MAXDELAY", K_MAXDELAY},
+    {"MAXEDGES", K_MAXEDGES},
+    {"MAXEDGESLOTSPACING", K_MAXEDGESLOTSPACING},
+    {"MAXLOAD", K_MAXLOAD},
+    {"MAXIMUMDENSITY", K_MAXIMUMDENSITY},
+    {"MAXVIASTACK", K_MAXVIASTACK},
+    {"MAXWIDTH", K_MAXWIDTH},
+    {"MAXXY", K_MAXXY},
+    {"MEGAHERTZ", K_MEGAHERTZ},
+    {"METALOVERHANG", K_METALOVERHANG},
+    {"MICRONS", K_MICRONS},
+    {"MILLIAMPS", K_MILLIAMPS},
+    {"MILLIWATTS", K_MILLIWATTS},
+    {"MINCUTS", K_MINCUTS},
+    {"MINENCLOSEDAREA", K_MINENCLOSEDAREA},
+    {"MINFEATURE", K_MINFEATURE},
+    {"MINIMUMCUT", K_MINIMUMCUT},
+    {"MINIMUMDENSITY", K_MINIMUMDENSITY},
+    {"MINPINS", K_MINPINS},
+    {"MINSIZE", K_MINSIZE},
+    {"MINSTEP", K_MINSTEP},
+    {"MINWIDTH", K_MINWIDTH},
+    {"MPWH", K_MPWH},
+    {"MPWL", K_MPWL},
+    {"MUSTJOIN", K_MUSTJOIN},
+    {"MX", K_MX},
+    {"MY", K_MY},
+    {"MXR90", K_MXR90},
+    {"MYR90", K_MYR90},
+    {"N", K_N},
+    {"NAMEMAPSTRING", K_NAMEMAPSTRING},
+    {"NAMESCASESENSITIVE", K_NAMESCASESENSITIVE},
+    {"NANOSECONDS", K_NANOSECONDS},
+    {"NEGEDGE", K_NEGEDGE},
+    {"NETEXPR", K_NETEXPR},
+    {"NETS", K_NETS},
+    {"NEW", K_NEW},
+    {"NONDEFAULTRULE", K_NONDEFAULTRULE},
+    {"NONE", K_NONE},
+    {"NONINVERT", K_NONINVERT},
+    {"NONUNATE", K_NONUNATE},
+    {"NOISETABLE", K_NOISETABLE},
+    {"NOTCHLENGTH", K_NOTCHLENGTH},
+    {"NOTCHSPACING", K_NOTCHSPACING},
+    {"NOWIREEXTENSIONATPIN", K_NOWIREEXTENSIONATPIN},
+    {"OBS", K_OBS},
+    {"OFF", K_OFF},
+    {"OFFSET", K_OFFSET},
+    {"OHMS", K_OHMS},
+    {"ON", K_ON},
+    {"OR", K_OR},
+    {"ORIENT", K_ORIENT},
+    {"ORIENTATION", K_ORIENTATION},
+    {"ORIGIN", K_ORIGIN},
+    {"ORTHOGONAL", K_ORTHOGONAL},
+    {"OUTPUT", K_OUTPUT},
+    {"OUTPUTPINANTENNASIZE", K_OUTPUTPINANTENNASIZE},
+    {"OUTPUTNOISEMARGIN", K_OUTPUTNOISEMARGIN},
+    {"OUTPUTRESISTANCE", K_OUTPUTRESISTANCE},
+    {"OUTSIDECORNER", K_OUTSIDECORNER},
+    {"OVERHANG", K_OVERHANG},
+    {"OVERLAP", K_OVERLAP},
+    {"OVERLAPS", K_OVERLAPS},
+    {"OXIDE1", K_OXIDE1},
+    {"OXIDE2", K_OXIDE2},
+    {"OXIDE3", K_OXIDE3},
+    {"OXIDE4", K_OXIDE4},
+    {"OXIDE5", K_OXIDE5},
+    {"OXIDE6", K_OXIDE6},
+    {"OXIDE7", K_OXIDE7},
+    {"OXIDE8", K_OXIDE8},
+    {"OXIDE9", K_OXIDE9},
+    {"OXIDE10", K_OXIDE10},
+    {"OXIDE11", K_OXIDE11},
+    {"OXIDE12", K_OXIDE12},
+    {"OXIDE13", K_OXIDE13},
+    {"OXIDE14", K_OXIDE14},
+    {"OXIDE15", K_OXIDE15},
+    {"OXIDE16", K_OXIDE16},
+    {"OXIDE17", K_OXIDE17},
+    {"OXIDE18", K_OXIDE18},
+    {"OXIDE19", K_OXIDE19},
+    {"OXIDE20", K_OXIDE20},
+    {"OXIDE21", K_OXIDE21},
+    {"OXIDE22", K_OXIDE22},
+    {"OXIDE23", K_OXIDE23},
+    {"OXIDE24", K_OXIDE24},
+    {"OXIDE25", K_OXIDE25},
+    {"OXIDE26", K_OXIDE26},
+    {"OXIDE27", K_OXIDE27},
+    {"OXIDE28", K_OXIDE28},
+    {"OXIDE29", K_OXIDE29},
+    {"OXIDE30", K_OXIDE30},
+    {"OXIDE31", K_OXIDE31},
+    {"OXIDE32", K_OXIDE32},
+    {"PAD", K_PAD},
+    {"PARALLELEDGE", K_PARALLELEDGE},
+    {"PARALLELOVERLAP", K_PARALLELOVERLAP},
+    {"PARALLELRUNLENGTH", K_PARALLELRUNLENGTH},
+    {"PATH", K_PATH},
+    {"PATTERN", K_PATTERN},
+    {"PEAK", K_PEAK},
+    {"PERIOD", K_PERIOD},
+    {"PGONLY", K_PGONLY},
+    {"PICOFARADS", K_PICOFARADS},
+    {"PIN", K_PIN},
+    {"PITCH", K_PITCH},
+    {"PLACED", K_PLACED},
+    {"POLYGON", K_POLYGON},
+    {"PORT", K_PORT},
+    {"POSEDGE", K_POSEDGE},
+    {"POST", K_POST},
+    {"POWER", K_POWER},
+    {"PRE", K_PRE},
+    {"PREFERENCLOSURE", K_PREFERENCLOSURE},
+    {"PRL", K_PRL},
+    {"PROPERTY", K_PROPERTY},
+    {"PROPERTYDEFINITIONS", K_PROPDEF},
+    {"PROTRUSIONWIDTH", K_PROTRUSIONWIDTH},
+    {"PULLDOWNRES", K_PULLDOWNRES},
+    {"PWL", K_PWL},
+    {"R0", K_R0},
+    {"R90", K_R90},
+    {"R180", K_R180},
+    {"R270", K_R270},
+    {"RANGE", K_RANGE},
+    {"REAL", K_REAL},
+    {"RECOVERY", K_RECOVERY},
+    {"RECT", K_RECT},
+    {"RESISTANCE", K_RESISTANCE},
+    {"RESISTIVE", K_RESISTIVE},
+    {"RING", K_RING},
+    {"RISE", K_RISE},
+    {"RISECS", K_RISECS},
+    {"RISERS", K_RISERS},
+    {"RISESATCUR", K_RISESATCUR},
+    {"RISESATT1", K_RISESATT1},
+    {"RISESLEWLIMIT", K_RISESLEWLIMIT},
+    {"RISET0", K_RISET0},
+    {"RISETHRESH", K_RISETHRESH},
+    {"RISEVOLTAGETHRESHOLD", K_RISEVOLTAGETHRESHOLD},
+    {"RMS", K_RMS},
+    {"ROUTING", K_ROUTING},
+    {"ROWABUTSPACING", K_ROWABUTSPACING},
+    {"ROWCOL", K_ROWCOL},
+    {"ROWMAJOR", K_ROWMAJOR},
+    {"ROWMINSPACING", K_ROWMINSPACING},
+    {"ROWPATTERN", K_ROWPATTERN},
+    {"RPERSQ", K_RPERSQ},
+    {"S", K_S},
+    {"SAMENET", K_SAMENET},
+    {"SCANUSE", K_SCANUSE},
+    {"SDFCOND", K_SDFCOND},
+    {"SDFCONDEND", K_SDFCONDEND},
+    {"SDFCONDSTART", K_SDFCONDSTART},
+    {"SETUP", K_SETUP},
+    {"SHAPE", K_SHAPE},
+    {"SHRINKAGE", K_SHRINKAGE},
+    {"SIGNAL", K_SIGNAL},
+    {"SITE", K_SITE},
+    {"SIZE", K_SIZE},
+    {"SKEW", K_SKEW},
+    {"SLOTLENGTH", K_SLOTLENGTH},
+    {"SLOTWIDTH", K_SLOTWIDTH},
+    {"SLOTWIRELENGTH", K_SLOTWIRELENGTH},
+    {"SLOTWIREWIDTH", K_SLOTWIREWIDTH},
+    {"SPLITWIREWIDTH", K_SPLITWIREWIDTH},
+    {"SOFT", K_SOFT},
+    {"SOURCE", K_SOURCE},
+    {"SPACER", K_SPACER},
+    {"SPACING", K_SPACING},
+    {"SPACINGTABLE", K_SPACINGTABLE},
+    {"SPECIALNETS", K_SPECIALNETS},
+    {"STABLE", K_STABLE},
+    {"STACK", K_STACK},
+    {"START", K_START},
+    {"STEP", K_STEP},
+    {"STOP", K_STOP},
+    {"STRING", K_STRING},
+    {"STRUCTURE", K_STRUCTURE},
+    {"SUPPLYSENSITIVITY", K_SUPPLYSENSITIVITY},
+    {"SYMMETRY", K_SYMMETRY},
+    {"TABLE", K_TABLE},
+    {"TABLEAXIS", K_TABLEAXIS},
+    {"TABLEDIMENSION", K_TABLEDIMENSION},
+    {"TABLEENTRIES", K_TABLEENTRIES},
+    {"TAPERRULE", K_TAPERRULE},
+    {"THEN", K_THEN},
+    {"THICKNESS", K_THICKNESS},
+    {"TIEHIGH", K_TIEHIGH},
+    {"TIELOW", K_TIELOW},
+    {"TIEOFFR", K_TIEOFFR},
+    {"TIME", K_TIME},
+    {"TIMING", K_TIMING},
+    {"TO", K_TO},
+    {"TOPIN", K_TOPIN},
+    {"TOPLEFT", K_TOPLEFT},
+    {"TOPOFSTACKONLY", K_TOPOFSTACKONLY},
+    {"TOPRIGHT", K_TOPRIGHT},
+    {"TRACKS", K_TRACKS},
+    {"TRANSITIONTIME", K_TRANSITIONTIME},
+    {"TRISTATE", K_TRISTATE},
+    {"TRUE", K_TRUE},
+    {"TWOEDGES", K_TWOEDGES},
+    {"TWOWIDTHS", K_TWOWIDTHS},
+    {"TYPE", K_TYPE},
+    {"UNATENESS", K_UNATENESS},
+    {"UNITS", K_UNITS},
+    {"UNIVERSALNOISEMARGIN", K_UNIVERSALNOISEMARGIN},
+    {"USE", K_USE},
+    {"USELENGTHTHRESHOLD", K_USELENGTHTHRESHOLD},
+    {"USEMINSPACING", K_USEMINSPACING},
+    {"USER", K_USER},
+    {"USEVIA", K_USEVIA},
+    {"USEVIARULE", K_USEVIARULE},
+    {"VARIABLE", K_VARIABLE},
+    {"VERSION", K_VERSION},
+    {"VERTICAL", K_VERTICAL},
+    {"VHI", K_VHI},
+    {"VIA", K_VIA},
+    {"VIARULE", K_VIARULE},
+    {"VICTIMLENGTH", K_VICTIMLENGTH},
+    {"VICTIMNOISE", K_VICTIMNOISE},
+    {"VIRTUAL", K_VIRTUAL},
+    {"VLO", K_VLO},
+    {"VOLTAGE", K_VOLTAGE},
+    {"VOLTS", K_VOLTS},
+    {"W", K_W},
+    {"WELLTAP", K_WELLTAP},
+    {"WIDTH", K_WIDTH},
+    {"WITHIN", K_WITHIN},
+    {"WIRECAP", K_WIRECAP},
+    {"WIREEXTENSION", K_WIREEXTENSION},
+    {"X", K_X},
+    {"Y", K_Y},
+};
+
+static constexpr int lefNumKeywords
+    = sizeof(lefKeywords) / sizeof(lefKeywords[0]);
+static constexpr unsigned lefKeywordBuckets = 256;
+static constexpr unsigned lefKeywordSlots = 2048;
+
+static constexpr unsigned lefUpper(char c)
+{
+  return (c >= 'a' && c <= 'z') ? c - 'a' + 'A' : (unsigned char) c;
+}
+
+// FNV-1a of the upper case name.
+static constexpr unsigned lefKeywordHash(const char* name)
+{
+  unsigned hash = 2166136261u;
+  for (; *name; name++)
+    hash = (hash ^ lefUpper(*name)) * 16777619u;
+  return hash;
+}
+
+static constexpr unsigned lefKeywordSlot(unsigned hash, unsigned seed)
+{
+  unsigned h = hash ^ (seed * 0x9e3779b9u);
+  h = (h ^ (h >> 16)) * 0x85ebca6bu;
+  h = (h ^ (h >> 13)) * 0xc2b2ae35u;
+  return (h ^ (h >> 16)) & (lefKeywordSlots - 1);
+}
+
+// The hash of a name selects a bucket, and the seed of the bucket spreads
+// its keywords over the slots.
+struct lefKeywordTable
+{
+  unsigned seed[lefKeywordBuckets];
+  int slot[lefKeywordSlots];  // index into lefKeywords, -1 if free
+};
+
+static constexpr bool lefKeywordSeedFits(const lefKeywordTable& table,
+                                        const unsigned* hash,
+                                        const int* members,
+                                        int numMembers,
+                                        unsigned seed)
+{
+  for (int i = 0; i < numMembers; i++) {
+    unsigned slot = lefKeywordSlot(hash[members[i]], seed);
+    if (table.slot[slot] >= 0)
+      return false;
+    for (int j = 0; j < i; j++)
+      if (lefKeywordSlot(hash[members[j]], seed) == slot)
+        return false;
+  }
+  return true;
+}
+
+// Hash and displace: the largest buckets are placed first, each with the
+// first seed that moves all of its keywords into distinct free slots.
+static constexpr lefKeywordTable lefMakeKeywordTable()
+{
+  lefKeywordTable table{};
+  unsigned hash[lefNumKeywords] = {};
+  int bucketSize[lefKeywordBuckets] = {};
+  int maxBucketSize = 0;
+  for (int i = 0; i < lefNumKeywords; i++) {
+    hash[i] = lefKeywordHash(lefKeywords[i].name);
+    int size = ++bucketSize[hash[i] % lefKeywordBuckets];
+    if (size > maxBucketSize)
+      maxBucketSize = size;
+  }
+  for (unsigned slot = 0; slot < lefKeywordSlots; slot++)
+    table.slot[slot] = -1;
+
+  int members[lefNumKeywords] = {};
+  for (int size = maxBucketSize; size > 0; size--) {
+    for (unsigned bucket = 0; bucket < lefKeywordBuckets; bucket++) {
+      if (bucketSize[bucket] != size)
+        continue;
+      int numMembers = 0;
+      for (int i = 0; i < lefNumKeywords; i++)
+        if (hash[i] % lefKeywordBuckets == bucket)
+          members[numMembers++] = i;
+      unsigned seed = 0;
+      while (!lefKeywordSeedFits(table, hash, members, numMembers, seed))
+        seed++;
+      table.seed[bucket] = seed;
+      for (int i = 0; i < numMembers; i++)
+        table.slot[lefKeywordSlot(hash[members[i]], seed)] = members[i];
+    }
+  }
+  return table;
+}
+
+static constexpr lefKeywordTable lefKeywordIndex = lefMakeKeywordTable();
+
+// Index of the keyword `name` in lefKeywords, -1 if it is none.
+static constexpr int lefFindKeyword(const char* name)
+{
+  unsigned hash = lefKeywordHash(name);
+  unsigned seed = lefKeywordIndex.seed[hash % lefKeywordBuckets];
+  int index = lefKeywordIndex.slot[lefKeywordSlot(hash, seed)];
+  if (index < 0)
+    return -1;
+  const char* keyword = lefKeywords[index].name;
+  for (; *name && lefUpper(*name) == (unsigned char) *keyword; name++)
+    keyword++;
+  return (*name == '\0' && *keyword == '\0') ? index : -1;
+}
+
+static constexpr bool lefKeywordIndexIsPerfect()
+{
+  for (int i = 0; i < lefNumKeywords; i++)
+    if (lefFindKeyword(lefKeywords[i].name) != i)
+      return false;
+  return true;
+}
+
+static_assert(lefKeywordIndexIsPerfect(), "LEF keyword hash is not perfect");
+
 inline int lefGetKeyword(const char* name, int* result)
 {
-  std::map<const char*, int, lefCompareCStrings>::iterator search
-      = lefSettings->Keyword_set.find(name);
-  if (search != lefSettings->Keyword_set.end()) {
-    *result = search->second;
+  int index = lefFindKeyword(name);
+  if (index >= 0) {
+    *result = lefKeywords[index].token;
     return TRUE;
   }
 
@@ -159,6 +720,25 @@ void lefReloadBuffer()
 
   nb = 0;
 
+  if (lefSettings->InputBuffer && !lefData->encrypted) {
+    // The whole input is in memory, so it is a single chunk.
+    if (!lefData->first_buffer || lefSettings->InputBufferSize < 4) {
+      lefData->next = NULL;
+      return;
+    }
+    lefData->first_buffer = 0;
+    lefData->encrypted
+        = encIsEncrypted((unsigned char*) lefSettings->InputBuffer);
+    if (!lefData->encrypted) {
+      lefData->buffer_start = lefData->next = lefSettings->InputBuffer;
+      lefData->last
+          = lefSettings->InputBuffer + lefSettings->InputBufferSize - 1;
+      return;
+    }
+    // Decode the rest from the file, behind the header just checked.
+    fseek(lefData->lefrFile, 4, SEEK_SET);
+  }
+
   if (lefData->first_buffer) {
     lefData->first_buffer = 0;
     if (lefSettings->ReadFunction) {
@@ -237,7 +817,7 @@ int lefGetc()
 
 void UNlefGetc(char ch)
 {
-  if ((lefData->next <= lefData->current_buffer)
+  if ((lefData->next <= lefData->buffer_start)
       || (lefData->input_level > 0)) {
     lefError(1111, "UNlefGetc: buffer access violation.");
   } else {
@@ -811,16 +1391,10 @@ int lefsublex()
   // if we get here we are in smart mode.  Parse token
   if (isalpha(fc) || fc == '&' || fc == '_') {
     int result;
-    char *ch, *uch;
-
-    for (ch = lefData->current_token, uch = lefData->uc_token; *ch != '\0';
-         ch++)
-      *uch++ = toupper(*ch);
-    *uch = '\0';
 
     lefData->Hist_text.resize(0);
 
-    if (lefGetKeyword(lefData->uc_token, &result)) {
+    if (lefGetKeyword(lefData->current_token, &result)) {
       if (K_HISTORY == result) {  // history - get up to ';'
         int c;
         int prev;
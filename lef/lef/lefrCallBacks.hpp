@@ -104,7 +104,7 @@ class lefrCallbacks
   lefrViaRuleCbkFnType ViaRuleCbk;
 };
 
-extern lefrCallbacks* lefCallbacks;
+extern thread_local lefrCallbacks* lefCallbacks;
 
 END_LEFDEF_PARSER_NAMESPACE
 
@@ -95,7 +95,7 @@ lefrCallbacks::lefrCallbacks()
 {
 }
 
-lefrCallbacks* lefCallbacks = NULL;
+thread_local lefrCallbacks* lefCallbacks = NULL;
 
 void lefrCallbacks::reset()
 {
@@ -39,7 +39,7 @@ BEGIN_LEFDEF_PARSER_NAMESPACE
 
 extern void* lefMalloc(size_t lef_size);
 
-lefrData* lefData = NULL;
+thread_local lefrData* lefData = NULL;
 
 lefrData::lefrData()
     : lefrFile(0),
@@ -53,6 +53,7 @@ lefrData::lefrData()
       macroName(NULL),
       ndName(0),
       next(NULL),
+      buffer_start(NULL),
       nonDefaultRuleName(NULL),
       outMsg(NULL),
       pinName(NULL),
@@ -259,6 +260,7 @@ lefrData::lefrData()
   lef_nlines = 1;
   last = current_buffer - 1;
   next = current_buffer;
+  buffer_start = current_buffer;
   encrypted = 0;
   first_buffer = 1;
   // 12/08/1999 -- Wanda da Rosa
@@ -96,6 +96,7 @@ class lefrData
   char* macroName;
   char* ndName;
   char* next;
+  char* buffer_start;  // start of the current input chunk
   char* nonDefaultRuleName;
   char* outMsg;
   char* pinName;
@@ -300,7 +301,9 @@ class lefrData
   int msgLimit[2][MAX_LEF_MSGS];
 };
 
-extern lefrData* lefData;
+// One reader per thread: each thread that calls lefrInit/lefrRead owns its
+// own data, settings and callbacks.
+extern thread_local lefrData* lefData;
 
 END_LEFDEF_PARSER_NAMESPACE
 
@@ -46,7 +46,7 @@ BEGIN_LEFDEF_PARSER_NAMESPACE
 
 #include "lef_parser.hpp"
 
-static const char* init_call_func = NULL;
+static thread_local const char* init_call_func = NULL;
 
 void lef_init(const char* func)
 {
@@ -439,7 +439,7 @@ void lefrSetUnusedCallbacks(lefrVoidCbkFnType func)
 }
 
 // These count up the number of times an unset callback is called...
-static int lefrUnusedCount[NOCBK];
+static thread_local int lefrUnusedCount[NOCBK];
 
 int lefrCountFunc(lefrCallbackType_e e, void* v, lefiUserData d)
 {
@@ -1511,6 +1511,20 @@ void lefrUnsetReadFunction()
   lefSettings->ReadFunction = 0;
 }
 
+void lefrSetInputBuffer(char* data, size_t size)
+{
+  LEF_INIT;
+  lefSettings->InputBuffer = data;
+  lefSettings->InputBufferSize = size;
+}
+
+void lefrUnsetInputBuffer()
+{
+  LEF_INIT;
+  lefSettings->InputBuffer = 0;
+  lefSettings->InputBufferSize = 0;
+}
+
 // Set the maximum number of warnings
 //
 // *****************************************************************************
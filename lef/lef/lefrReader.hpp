@@ -513,6 +513,14 @@ typedef size_t (*LEFI_READ_FUNCTION)(FILE*, char*, size_t);
 extern void lefrSetReadFunction(LEFI_READ_FUNCTION);
 extern void lefrUnsetReadFunction();
 
+// Routine to read the whole input from memory, e.g. a memory mapped file,
+// instead of the FILE* given to lefrRead. The lexer hands out characters
+// directly from the buffer and writes pushed back characters into it, so
+// it must stay valid and writable until lefrRead returns. Encrypted input
+// is still decoded from the FILE*.
+extern void lefrSetInputBuffer(char* data, size_t size);
+extern void lefrUnsetInputBuffer();
+
 // Routine to set the lefrWarning.log to open as append instead for write
 // New in 5.7
 extern void lefrSetOpenLogFileAppend();
@@ -41,15 +41,6 @@
 
 BEGIN_LEFDEF_PARSER_NAMESPACE
 
-struct lefCompareCStrings
-{
-  bool operator()(const char* lhs, const char* rhs) const
-  {
-    return std::strcmp(lhs, rhs) < 0;
-  }
-};
-
-typedef std::map<const char*, int, lefCompareCStrings> lefKeywordMap;
 typedef std::map<int, int> MsgsDisableMap;
 
 typedef std::set<std::string> StringSet;
@@ -72,7 +63,6 @@ class lefrSettings
  public:
   lefrSettings();
 
-  void init_symbol_table();
   static void reset();
   void addLef58Type(const char* lef58Type, const char** layerType);
 
@@ -87,6 +77,8 @@ class lefrSettings
 
   LEFI_LINE_NUMBER_FUNCTION LineNumberFunction;
   LEFI_READ_FUNCTION ReadFunction;
+  char* InputBuffer;
+  size_t InputBufferSize;
   int AntennaInoutWarnings;
   int AntennaInputWarnings;
   int AntennaOutputWarnings;
@@ -146,11 +138,9 @@ class lefrSettings
 
   lefrProps lefProps;
   static const char* lefOxides[lefMaxOxides];
-
-  lefKeywordMap Keyword_set;
 };
 
-extern lefrSettings* lefSettings;
+extern thread_local lefrSettings* lefSettings;
 
 END_LEFDEF_PARSER_NAMESPACE
 
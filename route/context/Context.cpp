@@ -1,10 +1,12 @@
 #include "Context.hpp"
 #include "../cugr2/GlobalRouter.h"
 #include "../object/Route.hpp"
+#include "../parser/guide.hpp"
 #include "../parser/parser.hpp"
 #include "../util/log.hpp"
-#include <fstream>
-#include <iomanip>
+#include "../util/output_buffer.hpp"
+#include "../util/parallel.hpp"
+#include <algorithm>
 #include <sta/Network.hh>
 
 namespace sca {
@@ -23,15 +25,30 @@ int Context::readLef(const char *lef_file) {
   if (m_tech == nullptr) {
     m_tech = std::make_unique<Technology>();
   }
+  m_lef_files.push_back(lef_file);
   return readLefImpl(lef_file, m_tech.get());
 }
 
-int Context::readDef(const char *def_file) {
+int Context::readLef(const std::vector<std::string> &lef_files) {
+  if (m_tech == nullptr) {
+    m_tech = std::make_unique<Technology>();
+  }
+  m_lef_files.insert(m_lef_files.end(), lef_files.begin(), lef_files.end());
+  return readLefImpl(lef_files, m_tech.get());
+}
+
+int Context::readDef(const char *def_file, bool use_routing) {
   m_design = std::make_unique<Design>();
   m_design->setTechnology(m_tech.get());
-  int res = readDefImpl(def_file, m_design.get());
+  m_design->setGcellSizeConfig(m_gcell_size);
+  m_def_file = def_file;
+  GuideData wiring;
+  int res = readDefImpl(def_file, m_design.get(),
+                        use_routing ? &wiring : nullptr);
   if (!res) {
     m_design->makeGrid();
+    if (use_routing)
+      res = makeRoutingTreesImpl(m_design.get(), wiring);
   }
   m_design->makeNetIndicesToRoute();
   return res;
@@ -58,71 +75,86 @@ int Context::readGuide(const char *guide_file) {
   return readGuideImpl(guide_file, m_design.get());
 }
 
-bool Context::writeGuide(const char *guide_file) {
-  std::ofstream fout(guide_file);
-  for (int i : m_design->netIndicesToRoute()) {
-    sca::Net *net = m_design->net(i);
-    if (net->routingTree() == nullptr) {
-      // skip
-      // fout << net->name() << std::endl;
-      // fout << "(\n)\n";
-    } else if (net->routingTree()->children.size() == 0) {
-      fout << net->name() << std::endl;
-      fout << "(\n";
-      const auto &tree = net->routingTree();
-      PointOnLayerT<int> p = m_design->grid()->gcellToDbu(*tree);
-      // TODO: check layer index
-      std::string layer_name_0 = m_tech->layer(p.layerIdx)->name();
-      std::string layer_name_1 = m_tech->layer(p.layerIdx + 1)->name();
-      fout << p.x << " " << p.y << " " << layer_name_0 << " " << p.x << " "
-           << p.y << " " << layer_name_1 << "\n";
-      fout << ")\n";
-    } else {
-      fout << net->name() << std::endl;
-      fout << "(\n";
-      GRTreeNode::preorder(
-          net->routingTree(), [&](std::shared_ptr<GRTreeNode> node) {
-            for (const auto &child : node->children) {
-              auto [p_x, q_x] = std::minmax(node->x, child->x);
-              auto [p_y, q_y] = std::minmax(node->y, child->y);
-              auto [p_z, q_z] = std::minmax(node->layerIdx, child->layerIdx);
-              if (p_z != q_z) {
-                PointOnLayerT<int> p = m_design->grid()->gcellToDbu(
-                    PointOnLayerT<int>(p_z, p_x, p_y));
-                for (int z = p_z; z < q_z; z++) {
-                  std::string layer_name_0 = m_tech->layer(z)->name();
-                  std::string layer_name_1 = m_tech->layer(z + 1)->name();
-                  fout << p.x << " " << p.y << " " << layer_name_0 << " " << p.x
-                       << " " << p.y << " " << layer_name_1 << "\n";
-                }
-              } else {
-                PointOnLayerT<int> p = m_design->grid()->gcellToDbu(
-                    PointOnLayerT<int>(p_z, p_x, p_y));
-                PointOnLayerT<int> q = m_design->grid()->gcellToDbu(
-                    PointOnLayerT<int>(q_z, q_x, q_y));
-                std::string p_layer_name = m_tech->layer(p.layerIdx)->name();
-                std::string q_layer_name = m_tech->layer(q.layerIdx)->name();
-                fout << p.x << " " << p.y << " " << p_layer_name << " " << q.x
-                     << " " << q.y << " " << q_layer_name << "\n";
-              }
-            }
-          });
-      fout << ")\n";
-    }
+int Context::writeGuide(const char *guide_file, bool binary) {
+  return writeGuideImpl(guide_file, m_design.get(), binary);
+}
+
+int Context::convertGuide(const char *in_file, const char *out_file) {
+  return convertGuideImpl(in_file, out_file, m_design.get());
+}
+
+int Context::writeDef(const char *def_file, bool routes) {
+  return writeDefImpl(def_file, m_design.get(), routes);
+}
+
+int Context::writeSpef(const char *spef_file, const std::string &corner_name,
+                       bool gzip) {
+  return writeSpefImpl(spef_file, m_design.get(), corner_name, gzip);
+}
+
+int Context::writeSnapshot(const char *snapshot_file, bool routes) {
+  return writeSnapshotImpl(snapshot_file, m_lef_files, m_def_file,
+                           m_design.get(), routes);
+}
+
+int Context::readSnapshot(const char *snapshot_file) {
+  if (m_tech == nullptr) {
+    m_tech = std::make_unique<Technology>();
   }
+  auto design = std::make_unique<Design>();
+  design->setTechnology(m_tech.get());
+  int res = readSnapshotImpl(snapshot_file, m_tech.get(), design.get(),
+                             m_lef_files, m_def_file);
+  if (res == 2) // the technology of the old design is gone
+    m_design = nullptr;
+  if (res)
+    return res;
+  m_design = std::move(design);
+  m_design->makeNetIndicesToRoute();
+  // keep the grid, and the routes, of the snapshot unless the gcell size was
+  // set in this session
+  const GcellSizeConfig &cfg = m_design->gcellSizeConfig();
+  if (!m_gcell_size_set) {
+    m_gcell_size = cfg;
+    return 0;
+  }
+  if (cfg.mode != m_gcell_size.mode || cfg.pitch != m_gcell_size.pitch ||
+      cfg.count != m_gcell_size.count ||
+      cfg.memory_mb != m_gcell_size.memory_mb)
+    return setGcellSize(m_gcell_size);
   return 0;
 }
 
+void Context::netSlacks(std::vector<Net *> &nets, std::vector<float> &slacks) {
+  nets.clear();
+  for (int i : m_design->netIndicesToRoute())
+    nets.push_back(m_design->net(i));
+  m_parasitics_builder->getNetSlacks(nets, slacks);
+}
+
 int Context::writeSlack(const char *slack_file) {
-  std::ofstream fout(slack_file);
-  if (!fout) {
+  std::vector<Net *> nets;
+  std::vector<float> slacks;
+  netSlacks(nets, slacks);
+  int num_nets = static_cast<int>(nets.size());
+  int num_parts = std::max(1, std::min(4 * numThreads(), num_nets));
+  std::vector<std::string> parts(static_cast<size_t>(num_parts));
+  parallelFor(0, num_parts, [&](int t) {
+    size_t begin = nets.size() * static_cast<size_t>(t) /
+                   static_cast<size_t>(num_parts);
+    size_t end = nets.size() * static_cast<size_t>(t + 1) /
+                 static_cast<size_t>(num_parts);
+    std::string &out = parts[static_cast<size_t>(t)];
+    for (size_t i = begin; i < end; i++) {
+      appendWord(out, nets[i]->name());
+      out += ' ';
+      appendFloat(out, slacks[i], 5);
+      out += '\n';
+    }
+  });
+  if (!writeBuffers(slack_file, parts)) {
     LOG_ERROR("can not open file %s", slack_file);
-    return false;
-  }
-  for (int i : m_design->netIndicesToRoute()) {
-    Net *net = m_design->net(i);
-    float slack = m_parasitics_builder->getNetSlack(net);
-    fout << net->name() << " " << std::setprecision(5) << slack << '\n';
+    return 1;
   }
   return 0;
 }
@@ -145,16 +177,38 @@ int Context::runCugr2() {
   return 0;
 }
 bool Context::setLayerRc(const std::string &layer_name, double res,
-                         double cap) {
-  return ctx()->technology()->addLayerRC(layer_name, res, cap);
+                         double cap, const std::string &corner_name) {
+  return ctx()->technology()->addLayerRC(layer_name, res, cap, corner_name);
 }
 
-int Context::estimateParasitcs() {
-  m_parasitics_builder->clearParasitics();
-  for (int i : m_design->netIndicesToRoute()) {
-    m_parasitics_builder->estimateParasitcs(m_design->net(i));
+int Context::setGcellSize(const GcellSizeConfig &cfg) {
+  m_gcell_size = cfg;
+  m_gcell_size_set = true;
+  if (m_design == nullptr || m_design->grid() == nullptr)
+    return 0;
+  // the routing trees are in gcell coordinates of the old grid
+  m_design->setGcellSizeConfig(cfg);
+  m_design->makeGrid();
+  for (int i = 0; i < m_design->numNets(); i++) {
+    if (m_design->net(i)->routingTree() != nullptr) {
+      LOG_WARN("gcell grid changed, dropping existing routing trees");
+      break;
+    }
   }
-  sta::Sta::sta()->delaysInvalid();
+  for (int i = 0; i < m_design->numNets(); i++)
+    m_design->net(i)->setRoutingTree(nullptr);
+  return 0;
+}
+
+int Context::estimateParasitcs(bool all, ReduceMode mode) {
+  if (all)
+    m_parasitics_builder->clearParasitics();
+  m_parasitics_builder->setReduceMode(mode);
+  std::vector<Net *> nets;
+  for (int i : m_design->netIndicesToRoute())
+    nets.push_back(m_design->net(i));
+  int num_changed = m_parasitics_builder->estimateParasitcs(nets);
+  LOG_INFO("estimated parasitics of %d of %zu nets", num_changed, nets.size());
   return 0;
 }
 } // namespace sca
@@ -21,19 +21,32 @@ public:
   Context();
 
   int readLef(const char *lef_file);
-  int readDef(const char *def_file);
+  int readLef(const std::vector<std::string> &lef_files);
+  // With `use_routing`, the regular wiring becomes the routing trees.
+  int readDef(const char *def_file, bool use_routing = false);
   int linkDesign(const char *design_name);
   static sta::Instance *linkFunc(const char *top_cell_name, bool, sta::Report *,
                                  sta::NetworkReader *);
 
   int readGuide(const char *guide_file);
-  bool writeGuide(const char *guide_file);
+  int writeGuide(const char *guide_file, bool binary);
+  int convertGuide(const char *in_file, const char *out_file);
+  int writeDef(const char *def_file, bool routes);
+  // RC of the routing trees with the layer RC of STA corner `corner_name`
+  int writeSpef(const char *spef_file, const std::string &corner_name,
+                bool gzip);
+  int writeSnapshot(const char *snapshot_file, bool routes);
+  int readSnapshot(const char *snapshot_file);
+  // slacks of the nets to route, in their order
+  void netSlacks(std::vector<Net *> &nets, std::vector<float> &slacks);
   int writeSlack(const char *slack_file);
-  bool setLayerRc(const std::string &layer_name, double res, double cap);
+  bool setLayerRc(const std::string &layer_name, double res, double cap,
+                  const std::string &corner_name = "");
+  int setGcellSize(const GcellSizeConfig &cfg);
 
 
   int runCugr2();
-  int estimateParasitcs();
+  int estimateParasitcs(bool all = false, ReduceMode mode = ReduceMode::Sta);
 
   Technology *technology() const { return m_tech.get(); }
   Design *design() const { return m_design.get(); }
@@ -47,5 +60,11 @@ private:
   std::unique_ptr<Technology> m_tech;
   std::unique_ptr<Design> m_design;
   std::unique_ptr<MakeWireParasitics> m_parasitics_builder;
+  GcellSizeConfig m_gcell_size;
+  // set_gcell_size was called in this session, snapshots follow it
+  bool m_gcell_size_set = false;
+  // sources of m_tech and m_design, recorded in snapshots
+  std::vector<std::string> m_lef_files;
+  std::string m_def_file;
 };
 } // namespace sca
@@ -56,10 +56,10 @@ GridGraph::GridGraph(sca::Design *design, const Parameters &params)
   graphEdges.assign(nLayers,
                     vector<vector<GraphEdge>>(xSize, vector<GraphEdge>(ySize)));
   for (int layerIdx = 0; layerIdx < nLayers; layerIdx++) {
+    const double *capacity = grid->edgeCapacities(layerIdx);
     for (int x = 0; x < xSize; x++)
       for (int y = 0; y < ySize; y++)
-        graphEdges[layerIdx][x][y].capacity =
-            grid->edgeCapacity(layerIdx, x, y);
+        graphEdges[layerIdx][x][y].capacity = capacity[x * ySize + y];
   }
   flag.assign(nLayers, vector<vector<bool>>(xSize, vector<bool>(ySize)));
 }
@@ -1,5 +1,7 @@
 #include "Design.hpp"
 #include "Helper.hpp"
+#include "../util/log.hpp"
+#include <cmath>
 
 namespace sca {
 
@@ -18,14 +20,64 @@ void Net::connect(Pin *pin) {
   pin->setNet(this);
 }
 
+// Rough footprint of one gcell on one layer: the Grid capacity plus the
+// capacity/demand pair of the cugr2 GridGraph edge.
+static constexpr double kBytesPerGcell = 3 * sizeof(double);
+
+DBU Design::gcellPitchForCount(long long count) const {
+  double area = static_cast<double>(m_die_box.width()) * m_die_box.height();
+  double pitch = std::sqrt(area / std::max(count, 1LL));
+  // snap to whole tracks of the finest track pattern
+  DBU track_step = 0;
+  for (const auto &tc : m_tcs) {
+    if (tc.step > 0 && (track_step == 0 || tc.step < track_step))
+      track_step = tc.step;
+  }
+  if (track_step > 0) {
+    double num_tracks = std::max(1., std::round(pitch / track_step));
+    return static_cast<DBU>(num_tracks) * track_step;
+  }
+  return std::max(1, static_cast<DBU>(std::ceil(pitch)));
+}
+
 Grid *Design::makeGrid() {
-  m_gcs.clear();
-  m_gcs.push_back({LayerDirection::Horizontal, 0, 4200,
-                   1 + (m_die_box.x.high + 2100) / 4200});
-  m_gcs.push_back({LayerDirection::Vertical, 0, 4200,
-                   1 + (m_die_box.y.high + 2100) / 4200});
+  DBU pitch = m_gcell_size.pitch;
+  std::vector<GridConfig> gcs;
+  switch (m_gcell_size.mode) {
+  case GcellSizeMode::Def:
+    gcs = m_gcs;
+    break;
+  case GcellSizeMode::Pitch:
+    break;
+  case GcellSizeMode::Count:
+    pitch = gcellPitchForCount(m_gcell_size.count);
+    break;
+  case GcellSizeMode::Memory: {
+    double bytes = m_gcell_size.memory_mb * 1024. * 1024.;
+    double per_gcell = kBytesPerGcell * std::max(1, m_tech->numLayers());
+    pitch = gcellPitchForCount(static_cast<long long>(bytes / per_gcell));
+  } break;
+  }
+  ASSERT(pitch > 0, "illegal gcell pitch %d", pitch);
 
-  m_grid = std::make_unique<Grid>(this);
+  // fill in the directions that DEF GCELLGRID does not specify
+  bool has_x = false, has_y = false;
+  for (const auto &gc : gcs) {
+    has_x |= gc.direction == LayerDirection::Vertical;
+    has_y |= gc.direction == LayerDirection::Horizontal;
+  }
+  if (!has_x) {
+    int count = (m_die_box.width() + pitch - 1) / pitch;
+    gcs.push_back({LayerDirection::Vertical, m_die_box.lx(), pitch, count});
+  }
+  if (!has_y) {
+    int count = (m_die_box.height() + pitch - 1) / pitch;
+    gcs.push_back({LayerDirection::Horizontal, m_die_box.ly(), pitch, count});
+  }
+
+  m_grid = std::make_unique<Grid>(this, gcs);
+  LOG_INFO("gcell grid: %d x %d x %d", m_grid->sizeX(), m_grid->sizeY(),
+           m_tech->numLayers());
   return m_grid.get();
 }
 
@@ -40,17 +92,29 @@ void Design::setDieBox(const BoxT<DBU> &box) {
 
 Instance *Design::makeTopInstance(const std::string &design_name) {
   Libcell *libcell = m_tech->makeLibcell(design_name);
-  m_top_instance = std::make_unique<Instance>(design_name, libcell);
-  m_top_instance->setLx(0);
-  m_top_instance->setLy(0);
-  m_top_instance->setOrientation(Orientation::N);
   if (m_die_box.IsValid()) {
     libcell->setWidth(m_die_box.width() / m_dbu);
     libcell->setHeight(m_die_box.height() / m_dbu);
   }
+  return makeTopInstance(design_name, libcell);
+}
+
+Instance *Design::makeTopInstance(const std::string &design_name,
+                                  Libcell *libcell) {
+  m_top_instance = std::make_unique<Instance>(design_name, libcell);
+  m_top_instance->setLx(0);
+  m_top_instance->setLy(0);
+  m_top_instance->setOrientation(Orientation::N);
   return m_top_instance.get();
 }
 
+void Design::reserve(size_t num_instances, size_t num_nets) {
+  m_instances.reserve(num_instances);
+  m_instance_name_map.reserve(num_instances);
+  m_nets.reserve(num_nets);
+  m_net_name_map.reserve(num_nets);
+}
+
 Instance *Design::makeInstance(const std::string &inst_name, Libcell *libcell) {
   return makeHelper(inst_name, m_instance_name_map, m_instances, inst_name,
                     libcell);
@@ -3,10 +3,17 @@
 #include "Grid.hpp"
 #include "Route.hpp"
 #include "Technology.hpp"
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+namespace sta {
+class Instance;
+class Net;
+class Pin;
+} // namespace sta
+
 namespace sca {
 
 class Instance;
@@ -26,11 +33,16 @@ public:
   Net *net() const { return m_net; }
   const PointOnLayerT<int> &position() const { return m_position; }
 
+  // set when the STA network is built
+  void setStaPin(sta::Pin *sta_pin) { m_sta_pin = sta_pin; }
+  sta::Pin *staPin() const { return m_sta_pin; }
+
 private:
   std::string m_name;
-  Net *m_net;
-  Instance *m_instance;
+  Net *m_net = nullptr;
+  Instance *m_instance = nullptr;
   PointOnLayerT<int> m_position; // on-grid
+  sta::Pin *m_sta_pin = nullptr;
 };
 
 class Instance {
@@ -46,18 +58,23 @@ public:
   void setOrientation(Orientation ori) { m_ori = ori; }
 
   const std::string &staName() const { return m_sta_name; }
+  void setStaInstance(sta::Instance *sta_inst) { m_sta_inst = sta_inst; }
+  sta::Instance *staInstance() const { return m_sta_inst; }
   DBU lx() const { return m_lx; }
   DBU ly() const { return m_ly; }
   Orientation orientation() const { return m_ori; }
 
   Pin *makePin(const std::string &pin_name);
   Pin *findPin(const std::string &pin_name) const;
+  int numPins() const { return static_cast<int>(m_pins.size()); }
+  Pin *pin(int idx) const { return m_pins[idx].get(); }
 
 private:
   std::string m_name;
   Libcell *m_libcell;
 
   std::string m_sta_name;
+  sta::Instance *m_sta_inst = nullptr;
   DBU m_lx, m_ly;
   Orientation m_ori;
 
@@ -72,6 +89,8 @@ public:
 
   void setStaName(const std::string &sta_name) { m_sta_name = sta_name; }
   const std::string &staName() const { return m_sta_name; }
+  void setStaNet(sta::Net *sta_net) { m_sta_net = sta_net; }
+  sta::Net *staNet() const { return m_sta_net; }
 
   void connect(Pin *pin);
   int numPins() const { return static_cast<int>(m_pins.size()); }
@@ -80,11 +99,17 @@ public:
   std::shared_ptr<GRTreeNode> routingTree() const { return m_tree; }
   void setRoutingTree(std::shared_ptr<GRTreeNode> tree) { m_tree = tree; }
 
+  // Hash of the RC tree last given to OpenSTA, 0 if there is none.
+  uint64_t parasiticsHash() const { return m_parasitics_hash; }
+  void setParasiticsHash(uint64_t hash) { m_parasitics_hash = hash; }
+
 private:
   std::string m_name;
   std::string m_sta_name;
+  sta::Net *m_sta_net = nullptr;
   std::vector<Pin *> m_pins;
   std::shared_ptr<GRTreeNode> m_tree;
+  uint64_t m_parasitics_hash = 0;
 };
 
 class Design {
@@ -94,6 +119,11 @@ public:
   void setDieBox(const BoxT<DBU> &box);
   void addTrackConfig(const TrackConfig &tc) { m_tcs.push_back(tc); }
   void addGridConfig(const GridConfig &gc) { m_gcs.push_back(gc); }
+  void setGcellSizeConfig(const GcellSizeConfig &cfg) { m_gcell_size = cfg; }
+  // DEF BLOCKAGES and special net shapes
+  void addObstruction(Layer *layer, const BoxT<DBU> &box) {
+    m_obs.emplace_back(layer, box);
+  }
   Grid *makeGrid();
 
   Technology *technology() const { return m_tech; }
@@ -101,12 +131,20 @@ public:
   const BoxT<DBU> &dieBox() const { return m_die_box; }
   const std::vector<TrackConfig> &trackConfigs() const { return m_tcs; }
   const std::vector<GridConfig> &gridConfigs() const { return m_gcs; }
+  const GcellSizeConfig &gcellSizeConfig() const { return m_gcell_size; }
+  const std::vector<std::pair<Layer *, BoxT<DBU>>> &obstructions() const {
+    return m_obs;
+  }
   Grid *grid() const { return m_grid.get(); }
 
   Instance *makeTopInstance(const std::string &design_name);
+  // Same as above, but with an existing libcell, e.g. from a snapshot
+  Instance *makeTopInstance(const std::string &design_name, Libcell *libcell);
   Instance *topInstance() const { return m_top_instance.get(); }
   const std::string &name() const { return m_top_instance->name(); }
 
+  // Make room for the given numbers of instances and nets up front
+  void reserve(size_t num_instances, size_t num_nets);
   Instance *makeInstance(const std::string &inst_name, Libcell *libcell);
   Net *makeNet(const std::string &net_name);
   Instance *findInstance(const std::string &inst_name) const;
@@ -120,11 +158,15 @@ public:
   const std::vector<int> &netIndicesToRoute() const { return m_net_indices; }
 
 private:
+  DBU gcellPitchForCount(long long count) const;
+
   Technology *m_tech;
   double m_dbu; // m_dbu * DBU == 1um
   BoxT<DBU> m_die_box;
   std::vector<TrackConfig> m_tcs;
-  std::vector<GridConfig> m_gcs;
+  std::vector<GridConfig> m_gcs; // from DEF GCELLGRID
+  GcellSizeConfig m_gcell_size;
+  std::vector<std::pair<Layer *, BoxT<DBU>>> m_obs;
   std::unique_ptr<Grid> m_grid;
 
   std::unique_ptr<Instance> m_top_instance;
@@ -1,15 +1,37 @@
 #include "Grid.hpp"
 #include "../util/log.hpp"
+#include "../util/parallel.hpp"
 #include "Design.hpp"
 #include <algorithm>
 
 namespace sca {
 
-Grid::Grid(Design *design) {
+static BoxT<DBU> instanceBox(const Instance *inst, double dbu) {
+  Libcell *libcell = inst->libcell();
+  return BoxT<DBU>(inst->lx(), inst->ly(),
+                   inst->lx() + static_cast<DBU>(dbu * libcell->width()),
+                   inst->ly() + static_cast<DBU>(dbu * libcell->height()));
+}
+
+static DBU uniformStep(const std::vector<DBU> &points) {
+  if (points.size() < 2)
+    return 0;
+  DBU step = points[1] - points[0];
+  for (size_t i = 1; i + 2 < points.size(); i++) {
+    if (points[i + 1] - points[i] != step)
+      return 0;
+  }
+  // the last gcell may be clipped by the die boundary
+  if (points[points.size() - 1] - points[points.size() - 2] > step)
+    return 0;
+  return step;
+}
+
+Grid::Grid(Design *design, const std::vector<GridConfig> &gcs) {
   m_design = design;
 
   // init grid point
-  for (const auto &gc : m_design->gridConfigs()) {
+  for (const auto &gc : gcs) {
     switch (gc.direction) {
     case LayerDirection::Horizontal:
       for (int i = 0; i < gc.count; i++) {
@@ -35,6 +57,8 @@ Grid::Grid(Design *design) {
   m_grid_points_y.erase(
       std::unique(m_grid_points_y.begin(), m_grid_points_y.end()),
       m_grid_points_y.end());
+  m_uniform_step_x = uniformStep(m_grid_points_x);
+  m_uniform_step_y = uniformStep(m_grid_points_y);
 
   // compute edge length
   m_edge_length_acc_x.push_back(0);
@@ -52,45 +76,194 @@ Grid::Grid(Design *design) {
     m_edge_length_acc_y.push_back(m_edge_length_acc_y.back() + y2 - y1);
   }
 
-  // compute capcity
+  makeTrackCapacity();
+  makeObstructionCapacity();
+}
+
+void Grid::makeTrackCapacity() {
   size_t num_cell_x = m_grid_points_x.size() - 1;
   size_t num_cell_y = m_grid_points_y.size() - 1;
-  size_t num_layer = m_design->technology()->numLayers();
-  m_edge_capcity.clear();
-  m_edge_capcity.resize(num_layer,
-                        std::vector<std::vector<double>>(
-                            num_cell_x, std::vector<double>(num_cell_y, 0.f)));
+  Technology *tech = m_design->technology();
+  int num_layer = tech->numLayers();
+  m_edge_capacity.assign(
+      static_cast<size_t>(num_layer) * num_cell_x * num_cell_y, 0.);
+
+  std::vector<std::vector<const TrackConfig *>> layer_tcs(
+      static_cast<size_t>(num_layer));
+  for (const auto &tc : m_design->trackConfigs())
+    layer_tcs[static_cast<size_t>(tc.layer->idx())].push_back(&tc);
+
+  // count the tracks of each gcell row (column) once, then broadcast the
+  // count along the row (column)
+  parallelFor(0, num_layer, [&](int l) {
+    bool hori = tech->layer(l)->direction() == LayerDirection::Horizontal;
+    const auto &points = hori ? m_grid_points_y : m_grid_points_x;
+    std::vector<double> num_tracks(points.size() - 1, 0.);
+    for (const TrackConfig *tc : layer_tcs[static_cast<size_t>(l)]) {
+      size_t i = 0;
+      for (int c = 0; c < tc->count; c++) {
+        DBU pos = tc->start + c * tc->step;
+        if (pos < points.front())
+          continue;
+        while (i + 1 < points.size() && pos >= points[i + 1])
+          i++;
+        if (i + 1 == points.size())
+          break;
+        num_tracks[i] += 1;
+      }
+    }
+
+    double *cap = m_edge_capacity.data() + capacityIndex(l, 0, 0);
+    if (hori) {
+      for (size_t ix = 0; ix + 1 < num_cell_x; ix++)
+        std::copy(num_tracks.begin(), num_tracks.end(),
+                  cap + ix * num_cell_y);
+    } else {
+      for (size_t ix = 0; ix < num_cell_x; ix++)
+        std::fill(cap + ix * num_cell_y, cap + (ix + 1) * num_cell_y - 1,
+                  num_tracks[ix]);
+    }
+  });
+}
+
+// An obstruction seen from a routing layer: `across` is perpendicular to the
+// tracks, `along` is parallel to them.
+struct TrackBlockage {
+  IntervalT<DBU> across, along;
+};
+
+void Grid::makeObstructionCapacity() {
+  Technology *tech = m_design->technology();
+  int num_layer = tech->numLayers();
+  double dbu = m_design->dbu();
+
+  std::vector<std::vector<BoxT<DBU>>> layer_obs(
+      static_cast<size_t>(num_layer));
+  bool has_obs = false;
+  for (const auto &[layer, box] : m_design->obstructions()) {
+    layer_obs[static_cast<size_t>(layer->idx())].push_back(box);
+    has_obs = true;
+  }
+  for (int i = 0; i < m_design->numInstances(); i++) {
+    Instance *inst = m_design->instance(i);
+    Libcell *libcell = inst->libcell();
+    if (libcell->numObstructions() == 0)
+      continue;
+    BoxT<DBU> inst_box = instanceBox(inst, dbu);
+    for (int j = 0; j < libcell->numObstructions(); j++) {
+      auto [layer, box] = libcell->obstruction(static_cast<size_t>(j));
+      BoxT<DBU> obs_box(
+          static_cast<DBU>(box.lx() * dbu), static_cast<DBU>(box.ly() * dbu),
+          static_cast<DBU>(box.hx() * dbu), static_cast<DBU>(box.hy() * dbu));
+      obs_box = getInternalPinBox(inst->orientation(), inst_box, obs_box);
+      layer_obs[static_cast<size_t>(layer->idx())].push_back(obs_box);
+      has_obs = true;
+    }
+  }
+  if (!has_obs)
+    return;
+
+  std::vector<std::vector<DBU>> layer_tracks(static_cast<size_t>(num_layer));
   for (const auto &tc : m_design->trackConfigs()) {
-    size_t l = static_cast<size_t>(tc.layer->idx());
-    switch (tc.layer->direction()) {
-    case LayerDirection::Horizontal: {
-      int y = tc.start;
-      size_t iy = 0;
-      for (int c = 0; c < tc.count; c++) {
-        while (y >= m_grid_points_y[iy + 1]) {
-          iy++;
-        }
-        for (size_t ix = 0; ix < num_cell_x - 1; ix++) {
-          m_edge_capcity[l][ix][iy] += 1;
+    auto &tracks = layer_tracks[static_cast<size_t>(tc.layer->idx())];
+    for (int c = 0; c < tc.count; c++)
+      tracks.push_back(tc.start + c * tc.step);
+  }
+
+  // Sweep the tracks of a layer in order, keeping the obstructions that
+  // cover the current track active. The union of their `along` intervals is
+  // the blocked part of the track, which is charged to the edges it
+  // overlaps as a fraction of one track.
+  parallelFor(0, num_layer, [&](int l) {
+    auto &obs = layer_obs[static_cast<size_t>(l)];
+    auto &tracks = layer_tracks[static_cast<size_t>(l)];
+    if (obs.empty() || tracks.empty())
+      return;
+    Layer *layer = tech->layer(l);
+    bool hori = layer->direction() == LayerDirection::Horizontal;
+    const auto &across_points = hori ? m_grid_points_y : m_grid_points_x;
+    const auto &along_points = hori ? m_grid_points_x : m_grid_points_y;
+    DBU half_width = static_cast<DBU>(layer->wireWidth() * dbu / 2);
+
+    std::vector<TrackBlockage> blockages;
+    blockages.reserve(obs.size());
+    for (const auto &box : obs) {
+      const auto &across = hori ? box.y : box.x;
+      const auto &along = hori ? box.x : box.y;
+      blockages.push_back({IntervalT<DBU>(across.low - half_width,
+                                          across.high + half_width),
+                           along});
+    }
+    std::sort(blockages.begin(), blockages.end(),
+              [](const TrackBlockage &a, const TrackBlockage &b) {
+                return a.across.low < b.across.low;
+              });
+    std::sort(tracks.begin(), tracks.end());
+
+    // edge e connects the centers of gcell e and e + 1
+    std::vector<DBU> centers(along_points.size() - 1);
+    for (size_t i = 0; i + 1 < along_points.size(); i++)
+      centers[i] = (along_points[i] + along_points[i + 1]) / 2;
+    size_t num_edges = centers.size() - 1;
+
+    std::vector<const TrackBlockage *> active;
+    std::vector<IntervalT<DBU>> blocked;
+    size_t next = 0;
+    size_t cell = 0;
+    for (DBU pos : tracks) {
+      if (pos < across_points.front() || pos >= across_points.back())
+        continue;
+      while (pos >= across_points[cell + 1])
+        cell++;
+      while (next < blockages.size() && blockages[next].across.low < pos)
+        active.push_back(&blockages[next++]);
+      active.erase(std::remove_if(active.begin(), active.end(),
+                                  [&](const TrackBlockage *b) {
+                                    return b->across.high <= pos;
+                                  }),
+                   active.end());
+      if (active.empty())
+        continue;
+
+      blocked.clear();
+      for (const TrackBlockage *b : active)
+        blocked.push_back(b->along);
+      std::sort(blocked.begin(), blocked.end(),
+                [](const IntervalT<DBU> &a, const IntervalT<DBU> &b) {
+                  return a.low < b.low;
+                });
+      size_t num_blocked = 0;
+      for (const auto &itv : blocked) {
+        if (num_blocked > 0 && itv.low <= blocked[num_blocked - 1].high) {
+          blocked[num_blocked - 1].high =
+              std::max(blocked[num_blocked - 1].high, itv.high);
+        } else {
+          blocked[num_blocked++] = itv;
         }
-        y += tc.step;
       }
-    } break;
-    case LayerDirection::Vertical: {
-      int x = tc.start;
-      size_t ix = 0;
-      for (int c = 0; c < tc.count; c++) {
-        while (x >= m_grid_points_x[ix + 1]) {
-          ix++;
-        }
-        for (size_t iy = 0; iy < num_cell_y - 1; iy++) {
-          m_edge_capcity[l][ix][iy] += 1;
+
+      for (size_t k = 0; k < num_blocked; k++) {
+        const auto &itv = blocked[k];
+        auto it = std::upper_bound(centers.begin(), centers.end(), itv.low);
+        size_t e = it == centers.begin()
+                       ? 0
+                       : static_cast<size_t>(it - centers.begin()) - 1;
+        for (; e < num_edges && centers[e] < itv.high; e++) {
+          DBU overlap = std::min(itv.high, centers[e + 1]) -
+                        std::max(itv.low, centers[e]);
+          if (overlap <= 0)
+            continue;
+          size_t idx = hori ? capacityIndex(l, static_cast<int>(e),
+                                            static_cast<int>(cell))
+                            : capacityIndex(l, static_cast<int>(cell),
+                                            static_cast<int>(e));
+          double ratio = static_cast<double>(overlap) /
+                         static_cast<double>(centers[e + 1] - centers[e]);
+          m_edge_capacity[idx] = std::max(0., m_edge_capacity[idx] - ratio);
         }
-        x += tc.step;
       }
-    } break;
     }
-  }
+  });
 }
 
 DBU Grid::wireLength(const PointT<int> &p, const PointT<int> &q) const {
@@ -108,9 +281,7 @@ void Grid::computeAccessPoints(Pin *pin, std::vector<PointOnLayerT<int>> &pts) {
   Instance *inst = pin->instance();
   Libcell *libcell = inst->libcell();
   double dbu = m_design->dbu();
-  BoxT<DBU> inst_box(inst->lx(), inst->ly(),
-                     inst->lx() + static_cast<DBU>(dbu * libcell->width()),
-                     inst->ly() + static_cast<DBU>(dbu * libcell->height()));
+  BoxT<DBU> inst_box = instanceBox(inst, dbu);
   Port *port = libcell->findPort(pin->name());
   ASSERT(port, "null port");
 
@@ -122,20 +293,11 @@ void Grid::computeAccessPoints(Pin *pin, std::vector<PointOnLayerT<int>> &pts) {
         static_cast<DBU>(box.hx() * dbu), static_cast<DBU>(box.hy() * dbu));
     pin_box = getInternalPinBox(inst->orientation(), inst_box, pin_box);
 
-    auto lx_it = std::upper_bound(m_grid_points_x.begin(),
-                                  m_grid_points_x.end(), pin_box.lx());
-    auto ly_it = std::upper_bound(m_grid_points_y.begin(),
-                                  m_grid_points_y.end(), pin_box.ly());
-    auto hx_it = std::lower_bound(m_grid_points_x.begin(),
-                                  m_grid_points_x.end(), pin_box.hx());
-    auto hy_it = std::lower_bound(m_grid_points_y.begin(),
-                                  m_grid_points_y.end(), pin_box.hy());
-    int lx =
-        static_cast<int>(std::distance(m_grid_points_x.begin(), lx_it)) - 1;
-    int ly =
-        static_cast<int>(std::distance(m_grid_points_y.begin(), ly_it)) - 1;
-    int hx = static_cast<int>(std::distance(m_grid_points_x.begin(), hx_it));
-    int hy = static_cast<int>(std::distance(m_grid_points_y.begin(), hy_it));
+    // lower_bound(v) == upper_bound(v - 1) on integer coordinates
+    int lx = gcellIndexX(pin_box.lx());
+    int ly = gcellIndexY(pin_box.ly());
+    int hx = gcellIndexX(pin_box.hx() - 1) + 1;
+    int hy = gcellIndexY(pin_box.hy() - 1) + 1;
     for (int x = lx; x < hx; x++) {
       for (int y = ly; y < hy; y++) {
         pts.emplace_back(z, x, y);
@@ -152,14 +314,36 @@ void Grid::computeAccessPoints(Pin *pin, std::vector<PointOnLayerT<int>> &pts) {
   }
 }
 
+// Index of the gcell containing x, i.e. upper_bound(x) - 1. Returns -1 left
+// of the die and sizeX() right of it.
+int Grid::gcellIndexX(DBU x) const {
+  if (m_uniform_step_x == 0) {
+    auto it =
+        std::upper_bound(m_grid_points_x.begin(), m_grid_points_x.end(), x);
+    return static_cast<int>(std::distance(m_grid_points_x.begin(), it)) - 1;
+  }
+  if (x < m_grid_points_x.front())
+    return -1;
+  if (x >= m_grid_points_x.back())
+    return sizeX();
+  return (x - m_grid_points_x.front()) / m_uniform_step_x;
+}
+
+int Grid::gcellIndexY(DBU y) const {
+  if (m_uniform_step_y == 0) {
+    auto it =
+        std::upper_bound(m_grid_points_y.begin(), m_grid_points_y.end(), y);
+    return static_cast<int>(std::distance(m_grid_points_y.begin(), it)) - 1;
+  }
+  if (y < m_grid_points_y.front())
+    return -1;
+  if (y >= m_grid_points_y.back())
+    return sizeY();
+  return (y - m_grid_points_y.front()) / m_uniform_step_y;
+}
+
 PointOnLayerT<int> Grid::dbuToGcell(const PointOnLayerT<int> &p) const {
-  auto x_it =
-      std::upper_bound(m_grid_points_x.begin(), m_grid_points_x.end(), p.x);
-  auto y_it =
-      std::upper_bound(m_grid_points_y.begin(), m_grid_points_y.end(), p.y);
-  int x = static_cast<int>(std::distance(m_grid_points_x.begin(), x_it)) - 1;
-  int y = static_cast<int>(std::distance(m_grid_points_y.begin(), y_it)) - 1;
-  return PointOnLayerT<int>(p.layerIdx, x, y);
+  return PointOnLayerT<int>(p.layerIdx, gcellIndexX(p.x), gcellIndexY(p.y));
 }
 
 PointOnLayerT<int> Grid::gcellToDbu(const PointOnLayerT<int> &p) const {
@@ -21,9 +21,23 @@ struct GridConfig {
   int count;
 };
 
+enum class GcellSizeMode { Def, Pitch, Count, Memory };
+
+// How Design::makeGrid chooses the gcell pitch.
+//   Def    : use DEF GCELLGRID, fall back to `pitch` if the DEF has none
+//   Pitch  : uniform grid with the given pitch
+//   Count  : uniform grid with about `count` gcells per layer
+//   Memory : uniform grid whose per-layer edges fit in `memory_mb`
+struct GcellSizeConfig {
+  GcellSizeMode mode = GcellSizeMode::Def;
+  DBU pitch = 4200;
+  long long count = 0;
+  double memory_mb = 0.;
+};
+
 class Grid {
 public:
-  Grid(Design *design);
+  Grid(Design *design, const std::vector<GridConfig> &gcs);
 
   int sizeX() const { return static_cast<int>(m_grid_points_x.size() - 1); }
   int sizeY() const { return static_cast<int>(m_grid_points_y.size() - 1); }
@@ -35,7 +49,11 @@ public:
   }
   DBU wireLength(const PointT<int> &p, const PointT<int> &q) const;
   double edgeCapacity(int l, int x, int y) const {
-    return m_edge_capcity[l][x][y];
+    return m_edge_capacity[capacityIndex(l, x, y)];
+  }
+  // capacities of layer l, indexed by x * sizeY() + y
+  const double *edgeCapacities(int l) const {
+    return m_edge_capacity.data() + capacityIndex(l, 0, 0);
   }
 
   void computeAccessPoints(Pin *pin, std::vector<PointOnLayerT<int>> &pts);
@@ -44,6 +62,18 @@ public:
   PointOnLayerT<int> dbuToGcell(const PointOnLayerT<int> &p) const;
 
 private:
+  size_t capacityIndex(int l, int x, int y) const {
+    return (static_cast<size_t>(l) * static_cast<size_t>(sizeX()) +
+            static_cast<size_t>(x)) *
+               static_cast<size_t>(sizeY()) +
+           static_cast<size_t>(y);
+  }
+  void makeTrackCapacity();
+  void makeObstructionCapacity();
+
+  int gcellIndexX(DBU x) const;
+  int gcellIndexY(DBU y) const;
+
   Design *m_design;
 
   std::vector<DBU> m_grid_points_x;     // dbu
@@ -52,7 +82,12 @@ private:
   std::vector<DBU> m_edge_length_y;     // dbu
   std::vector<DBU> m_edge_length_acc_x; // dbu
   std::vector<DBU> m_edge_length_acc_y; // dbu
-  std::vector<std::vector<std::vector<double>>> m_edge_capcity;
+  std::vector<double> m_edge_capacity; // [layer][x][y]
+
+  // uniform grids (every gcell but the last has the same pitch) map dbu to
+  // gcell with a division instead of a binary search
+  DBU m_uniform_step_x; // 0 if not uniform
+  DBU m_uniform_step_y; // 0 if not uniform
 };
 
 } // namespace sca
@@ -264,10 +264,13 @@ static std::shared_ptr<GRTreeNode> constructTree(std::vector<RouteSegment<int>>
 std::shared_ptr<GRTreeNode>
 buildTree(const std::vector<RouteSegment<int>> &segments,
           const Technology *tech) {
-  if (segments.size() == 0)
-    return nullptr;
+  return buildTree(std::vector<RouteSegment<int>>(segments), tech);
+}
 
-  std::vector<RouteSegment<int>> segs(segments);
+std::shared_ptr<GRTreeNode>
+buildTree(std::vector<RouteSegment<int>> &&segs, const Technology *tech) {
+  if (segs.size() == 0)
+    return nullptr;
 
   // printf("segments: \n");
   // for (const auto &[p, q] : segs)
@@ -39,6 +39,9 @@ class Technology;
 std::shared_ptr<GRTreeNode>
 buildTree(const std::vector<RouteSegment<int>> &segments,
           const Technology *tech);
+// Same as above, but works on the given segments instead of a copy
+std::shared_ptr<GRTreeNode>
+buildTree(std::vector<RouteSegment<int>> &&segments, const Technology *tech);
 
 // This function will split the tree into segments, and reconstruct the tree
 
@@ -11,6 +11,10 @@ Port *Libcell::makePort(const std::string &port_name) {
   return makeHelper(port_name, m_port_name_map, m_ports, port_name);
 }
 
+void Libcell::addObstruction(Layer *layer, const BoxT<double> &box) {
+  m_obs.emplace_back(layer, box);
+}
+
 Port *Libcell::findPort(const std::string &port_name) const {
   return findHelper(port_name, m_port_name_map);
 }
@@ -22,6 +26,8 @@ void Technology::reset() {
   m_cut_layer_name_map.clear();
   m_libcells.clear();
   m_libcell_name_map.clear();
+  m_via_cut_layer_map.clear();
+  updateLayerRC();
 }
 
 Layer *Technology::makeLayer(const std::string &layer_name) {
@@ -38,6 +44,15 @@ Libcell *Technology::makeLibcell(const std::string &libcell_name) {
   return makeHelper(libcell_name, m_libcell_name_map, m_libcells, libcell_name);
 }
 
+void Technology::makeVia(CutLayer *layer, const std::string &via_name) {
+  m_via_cut_layer_map[via_name] = layer->idx();
+}
+
+int Technology::findViaCutLayerIdx(const std::string &via_name) const {
+  auto it = m_via_cut_layer_map.find(via_name);
+  return it == m_via_cut_layer_map.end() ? -1 : it->second;
+}
+
 Layer *Technology::findLayer(const std::string &layer_name) const {
   return findHelper(layer_name, m_layer_name_map);
 }
@@ -50,50 +65,62 @@ Libcell *Technology::findLibcell(const std::string &libcell_name) const {
   return findHelper(libcell_name, m_libcell_name_map);
 }
 
-double Technology::layerRes(int idx) const {
-  Layer *layer = m_layers[idx].get();
-  auto result = findLayerRC(layer->name());
-  double res;
-  if(result){
-      //exist set_layer_rc 
-    res = result->first * 1e9;
-  }else{
-    res = 1e+6 * layer->sqRes() / layer->wireWidth();
+// A corner takes the layers it does not set from the default corner.
+void Technology::updateLayerRC() {
+  m_layer_res.clear();
+  m_layer_cap.clear();
+  for (int c = 0; c < numRcCorners(); c++) {
+    for (const auto &layer : m_layers) {
+      const std::pair<double, double> *rc = findLayerRC(layer->name(), c);
+      if (rc == nullptr)
+        rc = findLayerRC(layer->name());
+      if (rc) { // set by set_layer_rc
+        m_layer_res.push_back(rc->first * 1e9);
+        m_layer_cap.push_back(rc->second * 1e-9);
+      } else {
+        m_layer_res.push_back(1e+6 * layer->sqRes() / layer->wireWidth());
+        m_layer_cap.push_back(1e-6 * (layer->sqCap() * layer->wireWidth() +
+                                      layer->edgeCap() * 2.));
+      }
+    }
   }
-  return res;
+  m_cut_layer_res.clear();
+  for (const auto &cut_layer : m_cut_layers)
+    m_cut_layer_res.push_back(cut_layer->res());
 }
 
-double Technology::layerCap(int idx) const {
-  Layer *layer = m_layers[idx].get();
-  auto result = findLayerRC(layer->name().c_str());
-  double cap;
-  if(result){
-    //exist set_layer_rc 
-    cap  = result->second * 1e-9;  
-  }
-  else{
-    cap = 
-        1e-6 * (layer->sqCap() * layer->wireWidth() + layer->edgeCap() * 2.);
+bool Technology::addLayerRC(const std::string& layer_name, double resistance, double capacitance,
+                            const std::string &corner_name) {
+  int rc_corner = findRcCorner(corner_name);
+  if (rc_corner == 0 && !corner_name.empty()) {
+    rc_corner = numRcCorners();
+    m_rc_corner_names.push_back(corner_name);
+    m_layer_rc.emplace_back();
   }
-  return cap;
-}
-
-double Technology::cutLayerRes(int idx) const {
-  CutLayer *cut_layer = m_cut_layers[idx].get();
-  return cut_layer->res();
-}
-
-bool Technology::addLayerRC(const std::string& layer_name, double resistance, double capacitance) {
-  auto result = m_layer_rc.insert({layer_name, new std::pair(resistance, capacitance)});
+  auto &layer_rc = m_layer_rc[static_cast<size_t>(rc_corner)];
+  auto result = layer_rc.insert({layer_name, std::make_pair(resistance, capacitance)});
   if (!result.second) {
-      LOG_ERROR("Error: Layer %s set_layer_rc already exists and was not inserted.");
+      LOG_ERROR("Error: Layer %s set_layer_rc already exists and was not inserted.",
+                layer_name.c_str());
       return false; 
   }
+  updateLayerRC();
   return true; 
 }
 
-std::pair<double, double> *Technology::findLayerRC(const std::string& layer_name) const {
-  return findHelper(layer_name, m_layer_rc);
+const std::pair<double, double> *Technology::findLayerRC(const std::string& layer_name,
+                                                         int rc_corner) const {
+  const auto &layer_rc = m_layer_rc[static_cast<size_t>(rc_corner)];
+  auto it = layer_rc.find(layer_name);
+  return it == layer_rc.end() ? nullptr : &it->second;
+}
+
+int Technology::findRcCorner(const std::string &corner_name) const {
+  for (int c = 1; c < numRcCorners(); c++) {
+    if (m_rc_corner_names[static_cast<size_t>(c)] == corner_name)
+      return c;
+  }
+  return 0;
 }
 
 
@@ -46,10 +46,15 @@ public:
   void setRes(double r) { m_res = r; }
   double res() const { return m_res; }
 
+  // LEF via used when routes through this layer are written
+  void setViaName(const std::string &via_name) { m_via_name = via_name; }
+  const std::string &viaName() const { return m_via_name; }
+
 private:
   std::string m_name;
   int m_idx;
   double m_res;
+  std::string m_via_name;
 };
 
 class Port {
@@ -87,11 +92,19 @@ public:
   double width() const { return m_width; }
   double height() const { return m_height; }
 
+  // LEF OBS, relative to the cell origin
+  int numObstructions() const { return static_cast<int>(m_obs.size()); }
+  void addObstruction(Layer *layer, const BoxT<double> &box);
+  const std::pair<Layer *, BoxT<double>> &obstruction(size_t idx) const {
+    return m_obs[idx];
+  }
+
 private:
   std::string m_name;
   std::vector<std::unique_ptr<Port>> m_ports;
   std::unordered_map<std::string, Port *> m_port_name_map;
   double m_width, m_height;
+  std::vector<std::pair<Layer *, BoxT<double>>> m_obs; // um
 };
 
 class Technology {
@@ -114,34 +127,61 @@ public:
   CutLayer *findCutLayer(const std::string &cut_layer_name) const;
   Libcell *findLibcell(const std::string &libcell_name) const;
 
-  bool addLayerRC(const std::string& layer_name, double resistance, double capacitance);
-  std::pair<double, double> *findLayerRC(const std::string& layer_name) const;
-
-
-
-  double layerRes(int idx) const;
-  double layerCap(int idx) const;
-  double cutLayerRes(int idx) const;
+  // RC corners: 0 is the default one, the others are named after the STA
+  // corner they are for and only differ in the layers set for that corner.
+  bool addLayerRC(const std::string& layer_name, double resistance, double capacitance,
+                  const std::string &corner_name = "");
+  const std::pair<double, double> *findLayerRC(const std::string& layer_name,
+                                               int rc_corner = 0) const;
+  int numRcCorners() const { return static_cast<int>(m_rc_corner_names.size()); }
+  int findRcCorner(const std::string &corner_name) const; // 0 if none
+
+  // Rebuild the RC tables below from the LEF values and set_layer_rc. Called
+  // whenever layers or their RC change.
+  void updateLayerRC();
+  // per meter of wire for routing layers, per via for cut layers
+  double layerRes(int idx, int rc_corner = 0) const {
+    return m_layer_res[layerRcIndex(idx, rc_corner)];
+  }
+  double layerCap(int idx, int rc_corner = 0) const {
+    return m_layer_cap[layerRcIndex(idx, rc_corner)];
+  }
+  double cutLayerRes(int idx) const {
+    return m_cut_layer_res[static_cast<size_t>(idx)];
+  }
 
-  // void makeVia(CutLayer *layer, const std::string &via_name);
-  // size_t findViaCutLayerIdx(const std::string &via_name) const;
+  // vias by the cut layer they use, cut layer i connects layers i and i + 1
+  void makeVia(CutLayer *layer, const std::string &via_name);
+  int findViaCutLayerIdx(const std::string &via_name) const; // -1 if unknown
+  const std::unordered_map<std::string, int> &viaCutLayers() const {
+    return m_via_cut_layer_map;
+  }
 
 private:
   // layer
   std::vector<std::unique_ptr<Layer>> m_layers;
   std::unordered_map<std::string, Layer *> m_layer_name_map;
-  std::unordered_map<std::string, std::pair<double, double> *> m_layer_rc; //[0] command set_layer_rc flag,[1] resistance,[2] capacitance
+  size_t layerRcIndex(int idx, int rc_corner) const {
+    return static_cast<size_t>(rc_corner) * m_layers.size() +
+           static_cast<size_t>(idx);
+  }
+  std::vector<std::string> m_rc_corner_names{""};
+  // set_layer_rc resistance and capacitance by RC corner and layer name
+  std::vector<std::unordered_map<std::string, std::pair<double, double>>>
+      m_layer_rc{1};
+  std::vector<double> m_layer_res, m_layer_cap; // by RC corner and layer index
 
   // cut layer
   std::vector<std::unique_ptr<CutLayer>> m_cut_layers;
   std::unordered_map<std::string, CutLayer *> m_cut_layer_name_map;
+  std::vector<double> m_cut_layer_res;
 
   // libcell
   std::vector<std::unique_ptr<Libcell>> m_libcells;
   std::unordered_map<std::string, Libcell *> m_libcell_name_map;
 
-  // // via
-  // std::unordered_map<std::string, size_t> m_via_cut_layer_map;
+  // via
+  std::unordered_map<std::string, int> m_via_cut_layer_map;
 };
 
 }; // namespace sca
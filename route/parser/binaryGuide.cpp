@@ -0,0 +1,196 @@
+#include "binaryGuide.hpp"
+#include "../util/output_buffer.hpp"
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace sca {
+
+constexpr char BinaryGuide::kMagic[8];
+
+static uint64_t zigzag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+static void appendVarint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out += static_cast<char>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+static bool readVarint(const char *&p, const char *end, uint64_t &value) {
+  value = 0;
+  for (int shift = 0; p < end && shift < 64; shift += 7) {
+    uint64_t byte = static_cast<unsigned char>(*p++);
+    value |= (byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+template <class T> static void appendRaw(std::string &out, const T &value) {
+  out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+BinaryGuide::BinaryGuide(const std::string &path) : m_file(path) {
+  if (!m_file.isMapped() || m_file.size() < sizeof(m_header))
+    return;
+  std::memcpy(&m_header, m_file.data(), sizeof(m_header));
+  const uint64_t size = m_file.size();
+  const BinaryGuideHeader &h = m_header;
+  if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 ||
+      h.version != kVersion || h.file_size != size ||
+      h.num_layers > size / 8 || h.num_nets > size / 8)
+    return;
+  uint64_t num_names = h.num_layers + h.num_nets;
+  m_chars_offset = h.names_offset + (num_names + 1) * 8;
+  if (h.names_offset < sizeof(h) || m_chars_offset > h.index_offset ||
+      h.index_offset + (h.num_nets + 1) * 8 > h.records_offset ||
+      h.records_offset > size)
+    return;
+  // offsets must be ascending and stay inside their section
+  for (uint64_t i = 0; i < num_names; i++) {
+    if (word(h.names_offset + i * 8) > word(h.names_offset + i * 8 + 8))
+      return;
+  }
+  if (word(h.names_offset + num_names * 8) > h.index_offset - m_chars_offset)
+    return;
+  for (uint64_t i = 0; i < h.num_nets; i++) {
+    if (word(h.index_offset + i * 8) > word(h.index_offset + i * 8 + 8))
+      return;
+  }
+  if (word(h.index_offset + h.num_nets * 8) > size - h.records_offset)
+    return;
+  m_open = true;
+}
+
+bool BinaryGuide::isBinaryGuide(const std::string &path) {
+  char magic[sizeof(kMagic)];
+  std::ifstream fin(path, std::ios::binary);
+  return fin.read(magic, sizeof(magic)) &&
+         std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+uint64_t BinaryGuide::word(uint64_t offset) const {
+  uint64_t value;
+  std::memcpy(&value, m_file.data() + offset, sizeof(value));
+  return value;
+}
+
+std::string_view BinaryGuide::name(size_t idx) const {
+  uint64_t begin = word(m_header.names_offset + idx * 8);
+  uint64_t end = word(m_header.names_offset + idx * 8 + 8);
+  return std::string_view(m_file.data() + m_chars_offset + begin,
+                          static_cast<size_t>(end - begin));
+}
+
+bool BinaryGuide::readNet(size_t idx,
+                          std::vector<RouteSegment<int>> &segments) const {
+  const char *records = m_file.data() + m_header.records_offset;
+  const char *p = records + word(m_header.index_offset + idx * 8);
+  const char *end = records + word(m_header.index_offset + idx * 8 + 8);
+  uint64_t num_segments;
+  if (!readVarint(p, end, num_segments) ||
+      num_segments > static_cast<uint64_t>(end - p) / 6)
+    return false;
+  // decode one point relative to `base`
+  auto read_point = [&](const PointOnLayerT<int> &base,
+                        PointOnLayerT<int> &point) {
+    int64_t coords[3] = {base.layerIdx, base.x, base.y};
+    for (int64_t &coord : coords) {
+      uint64_t delta;
+      if (!readVarint(p, end, delta))
+        return false;
+      coord += unzigzag(delta);
+      if (coord < std::numeric_limits<int>::min() ||
+          coord > std::numeric_limits<int>::max())
+        return false;
+    }
+    point = PointOnLayerT<int>(static_cast<int>(coords[0]),
+                               static_cast<int>(coords[1]),
+                               static_cast<int>(coords[2]));
+    return point.layerIdx >= 0 && point.layerIdx < numLayers();
+  };
+  PointOnLayerT<int> last(0, 0, 0);
+  for (uint64_t i = 0; i < num_segments; i++) {
+    PointOnLayerT<int> start, stop;
+    if (!read_point(last, start) || !read_point(start, stop))
+      return false;
+    segments.emplace_back(start, stop);
+    last = stop;
+  }
+  return p == end;
+}
+
+BinaryGuideWriter::BinaryGuideWriter(
+    const std::vector<std::string_view> &layer_names, int size_x, int size_y)
+    : m_layer_names(layer_names), m_size_x(size_x), m_size_y(size_y) {}
+
+void BinaryGuideWriter::addNet(std::string_view name,
+                               const RouteSegment<int> *begin,
+                               const RouteSegment<int> *end) {
+  m_net_names.append(name.data(), name.size());
+  m_net_name_offsets.push_back(m_net_names.size());
+
+  auto append_point = [&](const PointOnLayerT<int> &base,
+                          const PointOnLayerT<int> &point) {
+    appendVarint(m_records, zigzag(int64_t(point.layerIdx) - base.layerIdx));
+    appendVarint(m_records, zigzag(int64_t(point.x) - base.x));
+    appendVarint(m_records, zigzag(int64_t(point.y) - base.y));
+  };
+  appendVarint(m_records, static_cast<uint64_t>(end - begin));
+  PointOnLayerT<int> last(0, 0, 0);
+  for (const RouteSegment<int> *segment = begin; segment != end; segment++) {
+    append_point(last, segment->start);
+    append_point(segment->start, segment->end);
+    last = segment->end;
+  }
+  m_record_offsets.push_back(m_records.size());
+}
+
+bool BinaryGuideWriter::write(const std::string &path) const {
+  // names: offsets of the layer names, then of the net names behind them
+  std::string layer_chars, name_offsets;
+  appendRaw(name_offsets, uint64_t(0));
+  for (const auto &name : m_layer_names) {
+    layer_chars.append(name.data(), name.size());
+    appendRaw(name_offsets, uint64_t(layer_chars.size()));
+  }
+  for (size_t i = 1; i < m_net_name_offsets.size(); i++)
+    appendRaw(name_offsets, layer_chars.size() + m_net_name_offsets[i]);
+  std::string padding((8 - (layer_chars.size() + m_net_names.size()) % 8) % 8,
+                      '\0');
+  std::string index;
+  for (uint64_t offset : m_record_offsets)
+    appendRaw(index, offset);
+
+  BinaryGuideHeader header;
+  std::memcpy(header.magic, BinaryGuide::kMagic, sizeof(header.magic));
+  header.version = BinaryGuide::kVersion;
+  header.num_layers = static_cast<uint32_t>(m_layer_names.size());
+  header.size_x = static_cast<uint32_t>(m_size_x);
+  header.size_y = static_cast<uint32_t>(m_size_y);
+  header.num_nets = m_record_offsets.size() - 1;
+  header.names_offset = sizeof(header);
+  header.index_offset = header.names_offset + name_offsets.size() +
+                        layer_chars.size() + m_net_names.size() +
+                        padding.size();
+  header.records_offset = header.index_offset + index.size();
+  header.file_size = header.records_offset + m_records.size();
+
+  return writeBuffers(
+      path, {std::string_view(reinterpret_cast<const char *>(&header),
+                              sizeof(header)),
+             name_offsets, layer_chars, m_net_names, padding, index,
+             m_records});
+}
+
+} // namespace sca
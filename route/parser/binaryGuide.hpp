@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../object/Route.hpp"
+#include "../util/mapped_file.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sca {
+
+// Compact binary form of a guide file. Segments are stored in gcells of the
+// grid the file was written for, so it can only be read back into a design
+// with the same grid. Integers are stored in host byte order, little endian
+// on all supported platforms; a foreign byte order fails the version check.
+//
+//   header        see BinaryGuideHeader
+//   names         uint64 offsets[num_layers + num_nets + 1] into the chars
+//                 that follow; layer names first, then net names
+//   index         uint64 offsets[num_nets + 1] into the records
+//   records       per net: varint number of segments, then for each segment
+//                 its start relative to the end of the previous segment (the
+//                 origin for the first one) and its end relative to its
+//                 start, as zigzag varints of layer, x and y
+//
+// The index allows a single net to be decoded without touching the others.
+struct BinaryGuideHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_layers;
+  uint32_t size_x, size_y; // grid size in gcells
+  uint64_t num_nets;
+  uint64_t names_offset;
+  uint64_t index_offset;
+  uint64_t records_offset;
+  uint64_t file_size;
+};
+
+class BinaryGuide {
+public:
+  static constexpr char kMagic[8] = {'S', 'C', 'A', 'G', 'U', 'I', 'D', 'E'};
+  static constexpr uint32_t kVersion = 1;
+
+  // Maps the file. isOpen() is false if it is not a valid binary guide.
+  explicit BinaryGuide(const std::string &path);
+
+  // Whether the file starts with the binary guide magic.
+  static bool isBinaryGuide(const std::string &path);
+
+  bool isOpen() const { return m_open; }
+  int numLayers() const { return static_cast<int>(m_header.num_layers); }
+  int sizeX() const { return static_cast<int>(m_header.size_x); }
+  int sizeY() const { return static_cast<int>(m_header.size_y); }
+  size_t numNets() const { return m_header.num_nets; }
+  std::string_view layerName(int idx) const {
+    return name(static_cast<size_t>(idx));
+  }
+  std::string_view netName(size_t idx) const {
+    return name(m_header.num_layers + idx);
+  }
+  // Append the segments of the idx-th net. Returns false if its record is
+  // corrupt.
+  bool readNet(size_t idx, std::vector<RouteSegment<int>> &segments) const;
+
+private:
+  uint64_t word(uint64_t offset) const;
+  std::string_view name(size_t idx) const;
+
+  MappedFile m_file;
+  BinaryGuideHeader m_header;
+  bool m_open = false;
+  uint64_t m_chars_offset = 0; // of the name characters
+};
+
+// Collects nets and writes them as a binary guide.
+class BinaryGuideWriter {
+public:
+  BinaryGuideWriter(const std::vector<std::string_view> &layer_names,
+                    int size_x, int size_y);
+
+  void addNet(std::string_view name, const RouteSegment<int> *begin,
+              const RouteSegment<int> *end);
+  // Returns false if the file could not be written.
+  bool write(const std::string &path) const;
+
+private:
+  std::vector<std::string_view> m_layer_names;
+  int m_size_x, m_size_y;
+  std::string m_net_names;
+  std::vector<uint64_t> m_net_name_offsets{0};
+  std::string m_records;
+  std::vector<uint64_t> m_record_offsets{0};
+};
+
+} // namespace sca
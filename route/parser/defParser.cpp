@@ -1,5 +1,12 @@
+#include "parser.hpp"
+#include "guide.hpp"
 #include "../object/Design.hpp"
+#include "../util/gzip_reader.hpp"
 #include "../util/log.hpp"
+#include "../util/mapped_file.hpp"
+#include "../util/parallel.hpp"
+#include <algorithm>
+#include <cctype>
 #include <cstring>
 #include <defrReader.hpp>
 
@@ -76,30 +83,224 @@ static int pinCbk(defrCallbackType_e, defiPin *def_pin, void *data) {
   return 0;
 }
 
-static int componentCbk(defrCallbackType_e, defiComponent *def_comp,
-                        void *data) {
+static int viaCbk(defrCallbackType_e, defiVia *def_via, void *data) {
   Design *design = reinterpret_cast<Design *>(data);
-  Libcell *libcell = design->technology()->findLibcell(def_comp->name());
-  Instance *inst = design->makeInstance(def_comp->id(), libcell);
-  inst->setOrientation(static_cast<Orientation>(def_comp->placementOrient()));
-  inst->setLx(def_comp->placementX());
-  inst->setLy(def_comp->placementY());
+  Technology *tech = design->technology();
+  CutLayer *cut_layer = nullptr;
+  if (def_via->hasViaRule()) {
+    char *rule, *bot_layer, *cut_layer_name, *top_layer;
+    int x_size, y_size, x_spacing, y_spacing, x_bot_enc, y_bot_enc, x_top_enc,
+        y_top_enc;
+    def_via->viaRule(&rule, &x_size, &y_size, &bot_layer, &cut_layer_name,
+                     &top_layer, &x_spacing, &y_spacing, &x_bot_enc,
+                     &y_bot_enc, &x_top_enc, &y_top_enc);
+    cut_layer = tech->findCutLayer(cut_layer_name);
+  } else {
+    for (int i = 0; i < def_via->numLayers() && cut_layer == nullptr; i++) {
+      char *layer_name;
+      int xl, yl, xh, yh;
+      def_via->layer(i, &layer_name, &xl, &yl, &xh, &yh);
+      cut_layer = tech->findCutLayer(layer_name);
+    }
+  }
+  if (cut_layer)
+    tech->makeVia(cut_layer, def_via->name());
   return 0;
 }
 
-static int netCbk(defrCallbackType_e, defiNet *def_net, void *data) {
-  Design *design = reinterpret_cast<Design *>(data);
-  Net *net = design->makeNet(def_net->name());
-  for (int i = 0; i < def_net->numConnections(); i++) {
-    if (std::strcmp(def_net->instance(i), "PIN") == 0) { // io pin
-      Pin *pin = design->topInstance()->makePin(def_net->pin(i));
+// Regular wiring of the NETS section, in dbu. The reader hands the paths
+// over one at a time as they are parsed, so they are never collected in the
+// defiNet; each is turned into segments right away.
+struct DefWiring {
+  const Technology *tech;
+  GuideData *data;
+  bool in_nets = false;
+  size_t net_begin = 0; // first segment of the current net
+  size_t num_unknown_vias = 0;
+};
+
+// The user data of the reader is the Design or the staging area, so the
+// wiring of the calling thread is kept here.
+static thread_local DefWiring *t_def_wiring = nullptr;
+// Whether the reader of the calling thread is in the SPECIALNETS section.
+// Set by the SNET callbacks and cleared around every read, since a read
+// that fails inside the section never gets to its end callback.
+static thread_local bool t_in_special_nets = false;
+
+static int netStartCbk(defrCallbackType_e, int, void *) {
+  t_def_wiring->in_nets = true;
+  return 0;
+}
+
+static int netEndCbk(defrCallbackType_e, void *, void *) {
+  t_def_wiring->in_nets = false;
+  return 0;
+}
+
+static int netNameCbk(defrCallbackType_e, const char *, void *) {
+  t_def_wiring->net_begin = t_def_wiring->data->segments.size();
+  return 0;
+}
+
+// Wires become segments on their layer, vias segments between the two
+// layers of their cut layer, after which the path goes on on the other one.
+static void addWiringPath(const defiPath *path, DefWiring &wiring) {
+  const Technology *tech = wiring.tech;
+  std::vector<RouteSegment<int>> &segments = wiring.data->segments;
+  int layer = -1;
+  bool has_prev = false;
+  int prev_x = 0, prev_y = 0;
+  path->initTraverse();
+  for (int e = path->next(); e != DEFIPATH_DONE; e = path->next()) {
+    int x = 0, y = 0, ext = 0;
+    switch (e) {
+    case DEFIPATH_LAYER: {
+      const Layer *routing_layer = tech->findLayer(path->getLayer());
+      layer = routing_layer ? routing_layer->idx() : -1;
+      has_prev = false;
+    } break;
+    case DEFIPATH_POINT:
+    case DEFIPATH_FLUSHPOINT:
+      if (e == DEFIPATH_POINT)
+        path->getPoint(&x, &y);
+      else
+        path->getFlushPoint(&x, &y, &ext);
+      if (has_prev && layer >= 0 && (x != prev_x || y != prev_y))
+        segments.emplace_back(PointOnLayerT<int>(layer, prev_x, prev_y),
+                              PointOnLayerT<int>(layer, x, y));
+      prev_x = x;
+      prev_y = y;
+      has_prev = true;
+      break;
+    case DEFIPATH_VIRTUALPOINT: // not connected by a wire
+      path->getVirtualPoint(&prev_x, &prev_y);
+      has_prev = true;
+      break;
+    case DEFIPATH_VIA: {
+      if (!has_prev || layer < 0)
+        break;
+      int cut = tech->findViaCutLayerIdx(path->getVia());
+      int other = layer + 1;
+      if (cut < 0)
+        wiring.num_unknown_vias++;
+      else
+        other = layer <= cut ? cut + 1 : cut;
+      if (other < 0 || other >= tech->numLayers())
+        break;
+      segments.emplace_back(PointOnLayerT<int>(layer, prev_x, prev_y),
+                            PointOnLayerT<int>(other, prev_x, prev_y));
+      layer = other;
+    } break;
+    default:
+      break;
+    }
+  }
+}
+
+static void warnUnknownVias(size_t num_unknown_vias,
+                            const std::string &def_file_path) {
+  if (num_unknown_vias > 0)
+    LOG_WARN("%zu vias of unknown layers in DEF file `%s` are taken to go "
+             "one layer up",
+             num_unknown_vias, def_file_path.c_str());
+}
+
+// Components and nets as read from the file. Sections parsed on worker
+// threads are staged this way and merged into the Design in file order.
+struct DefComponent {
+  std::string name, libcell;
+  Orientation orient;
+  DBU x, y;
+};
+
+struct DefConnection {
+  std::string instance, pin;
+};
+
+struct DefNet {
+  std::string name;
+  std::vector<DefConnection> connections;
+  size_t wiring_begin = 0, wiring_end = 0; // segments in DefStaging::wiring
+};
+
+struct DefStaging {
+  std::vector<DefComponent> components;
+  std::vector<DefNet> nets;
+  GuideData wiring;
+  size_t num_unknown_vias = 0;
+};
+
+static DefComponent readComponent(const defiComponent *def_comp) {
+  return {def_comp->id(), def_comp->name(),
+          static_cast<Orientation>(def_comp->placementOrient()),
+          def_comp->placementX(), def_comp->placementY()};
+}
+
+static DefNet readNet(defiNet *def_net) {
+  DefNet net;
+  net.name = def_net->name();
+  net.connections.reserve(static_cast<size_t>(def_net->numConnections()));
+  for (int i = 0; i < def_net->numConnections(); i++)
+    net.connections.push_back({def_net->instance(i), def_net->pin(i)});
+  return net;
+}
+
+static void makeComponent(const DefComponent &comp, Design *design) {
+  Libcell *libcell = design->technology()->findLibcell(comp.libcell);
+  Instance *inst = design->makeInstance(comp.name, libcell);
+  inst->setOrientation(comp.orient);
+  inst->setLx(comp.x);
+  inst->setLy(comp.y);
+}
+
+static Net *makeNet(const DefNet &def_net, Design *design) {
+  Net *net = design->makeNet(def_net.name);
+  for (const auto &conn : def_net.connections) {
+    if (conn.instance == "PIN") { // io pin
+      Pin *pin = design->topInstance()->makePin(conn.pin);
       net->connect(pin);
     } else {
-      Instance *inst = design->findInstance(def_net->instance(i));
-      Pin *pin = inst->makePin(def_net->pin(i));
+      Instance *inst = design->findInstance(conn.instance);
+      Pin *pin = inst->makePin(conn.pin);
       net->connect(pin);
     }
   }
+  return net;
+}
+
+static int componentCbk(defrCallbackType_e, defiComponent *def_comp,
+                        void *data) {
+  Design *design = reinterpret_cast<Design *>(data);
+  makeComponent(readComponent(def_comp), design);
+  return 0;
+}
+
+static int netCbk(defrCallbackType_e, defiNet *def_net, void *data) {
+  Design *design = reinterpret_cast<Design *>(data);
+  Net *net = makeNet(readNet(def_net), design);
+  if (t_def_wiring) {
+    GuideData *wiring = t_def_wiring->data;
+    if (wiring->segments.size() > t_def_wiring->net_begin)
+      wiring->nets.push_back(
+          {net, t_def_wiring->net_begin, wiring->segments.size()});
+  }
+  return 0;
+}
+
+static int stageComponentCbk(defrCallbackType_e, defiComponent *def_comp,
+                             void *data) {
+  DefStaging *staging = reinterpret_cast<DefStaging *>(data);
+  staging->components.push_back(readComponent(def_comp));
+  return 0;
+}
+
+static int stageNetCbk(defrCallbackType_e, defiNet *def_net, void *data) {
+  DefStaging *staging = reinterpret_cast<DefStaging *>(data);
+  staging->nets.push_back(readNet(def_net));
+  if (t_def_wiring) {
+    staging->nets.back().wiring_begin = t_def_wiring->net_begin;
+    staging->nets.back().wiring_end = staging->wiring.segments.size();
+  }
   return 0;
 }
 
@@ -135,9 +336,195 @@ static int gcellGridCbk(defrCallbackType_e, defiGcellGrid *def_grid,
   return 0;
 }
 
-int readDefImpl(const std::string &def_file_path, Design *design) {
+// Polygons are split into rectangles like in LEF obstructions.
+static void addPolygonObstructions(const defiPoints &points, Layer *layer,
+                                   Design *design) {
+  std::vector<BoxT<DBU>> boxes;
+  SplitPolygon(points.x, points.y, points.numPoints, boxes);
+  for (const BoxT<DBU> &box : boxes)
+    design->addObstruction(layer, box);
+}
+
+static int blockageCbk(defrCallbackType_e, defiBlockage *def_blockage,
+                       void *data) {
+  Design *design = reinterpret_cast<Design *>(data);
+  if (!def_blockage->hasLayer())
+    return 0; // placement blockage
+  Layer *layer = design->technology()->findLayer(def_blockage->layerName());
+  if (layer == nullptr)
+    return 0; // cut layer
+  for (int i = 0; i < def_blockage->numRectangles(); i++) {
+    design->addObstruction(
+        layer, BoxT<DBU>(def_blockage->xl(i), def_blockage->yl(i),
+                         def_blockage->xh(i), def_blockage->yh(i)));
+  }
+  for (int i = 0; i < def_blockage->numPolygons(); i++)
+    addPolygonObstructions(def_blockage->getPolygon(i), layer, design);
+  return 0;
+}
+
+static void addPathObstructions(const defiPath *path, Design *design) {
+  Layer *layer = nullptr;
+  DBU half_width = 0;
+  bool has_prev = false;
+  int prev_x = 0, prev_y = 0;
+  path->initTraverse();
+  for (int e = path->next(); e != DEFIPATH_DONE; e = path->next()) {
+    int x = 0, y = 0, ext = 0;
+    switch (e) {
+    case DEFIPATH_LAYER:
+      layer = design->technology()->findLayer(path->getLayer());
+      has_prev = false;
+      break;
+    case DEFIPATH_WIDTH:
+      half_width = path->getWidth() / 2;
+      break;
+    case DEFIPATH_POINT:
+    case DEFIPATH_FLUSHPOINT:
+      if (e == DEFIPATH_POINT)
+        path->getPoint(&x, &y);
+      else
+        path->getFlushPoint(&x, &y, &ext);
+      if (has_prev && layer != nullptr) {
+        auto [lx, hx] = std::minmax(prev_x, x);
+        auto [ly, hy] = std::minmax(prev_y, y);
+        design->addObstruction(layer,
+                               BoxT<DBU>(lx - half_width, ly - half_width,
+                                         hx + half_width, hy + half_width));
+      }
+      prev_x = x;
+      prev_y = y;
+      has_prev = true;
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+// Special wiring reaches pathCbk below path by path, only the shapes that
+// are not paths are left in the defiNet.
+static int specialNetCbk(defrCallbackType_e, defiNet *def_net, void *data) {
+  Design *design = reinterpret_cast<Design *>(data);
+  Technology *tech = design->technology();
+  for (int i = 0; i < def_net->numRectangles(); i++) {
+    Layer *layer = tech->findLayer(def_net->rectName(i));
+    if (layer)
+      design->addObstruction(layer,
+                             BoxT<DBU>(def_net->xl(i), def_net->yl(i),
+                                       def_net->xh(i), def_net->yh(i)));
+  }
+  for (int i = 0; i < def_net->numPolygons(); i++) {
+    Layer *layer = tech->findLayer(def_net->polygonName(i));
+    if (layer)
+      addPolygonObstructions(def_net->getPolygon(i), layer, design);
+  }
+  return 0;
+}
+
+static int specialNetStartCbk(defrCallbackType_e, int, void *) {
+  t_in_special_nets = true;
+  return 0;
+}
+
+static int specialNetEndCbk(defrCallbackType_e, void *, void *) {
+  t_in_special_nets = false;
+  return 0;
+}
+
+// With a path callback the reader hands over the paths of both sections
+// here instead of adding them to the defiNet. Special wiring becomes
+// obstructions, the user data being the Design whenever SPECIALNETS is read.
+static int pathCbk(defrCallbackType_e, defiPath *path, void *data) {
+  if (t_in_special_nets)
+    addPathObstructions(path, reinterpret_cast<Design *>(data));
+  else if (t_def_wiring && t_def_wiring->in_nets)
+    addWiringPath(path, *t_def_wiring);
+  return 0;
+}
+
+static void setWiringCallbacks() {
+  defrSetNetStartCbk(netStartCbk);
+  defrSetNetEndCbk(netEndCbk);
+  defrSetNetNameCbk(netNameCbk);
+  defrSetPathCbk(pathCbk);
+}
+
+// A COMPONENTS or NETS section: the header line, the statements and the
+// END line, each as a byte range of the file.
+struct DefSection {
+  const char *begin, *body, *body_end, *end;
+};
+
+static const char *skipBlanks(const char *p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    p++;
+  return p;
+}
+
+static bool isToken(const char *p, const char *end, const char *token) {
+  size_t len = std::strlen(token);
+  if (static_cast<size_t>(end - p) < len || std::memcmp(p, token, len) != 0)
+    return false;
+  return p + len == end || std::isspace(static_cast<unsigned char>(p[len]));
+}
+
+// Find the COMPONENTS and NETS sections line by line, along with the
+// prologue up to the DESIGN statement that every chunk is parsed with.
+// Returns false if the layout is not the plain one this relies on.
+static bool findDefSections(const char *data, size_t size,
+                            std::vector<DefSection> &sections,
+                            const char *&prologue_end) {
+  const char *end = data + size;
+  const char *section_token = nullptr;
+  prologue_end = nullptr;
+  for (const char *line = data; line < end;) {
+    const void *eol = std::memchr(line, '\n', static_cast<size_t>(end - line));
+    const char *line_end = eol ? static_cast<const char *>(eol) + 1 : end;
+    const char *p = skipBlanks(line, line_end);
+    if (section_token == nullptr) {
+      if (isToken(p, line_end, "COMPONENTS") || isToken(p, line_end, "NETS")) {
+        // the header has to be a line of its own
+        if (std::memchr(p, ';', static_cast<size_t>(line_end - p)) == nullptr)
+          return false;
+        section_token = *p == 'C' ? "COMPONENTS" : "NETS";
+        sections.push_back({line, line_end, nullptr, nullptr});
+        if (prologue_end == nullptr)
+          prologue_end = line;
+      } else if (prologue_end == nullptr && isToken(p, line_end, "DESIGN")) {
+        prologue_end = line;
+      }
+    } else if (isToken(p, line_end, "END") &&
+               isToken(skipBlanks(p + 3, line_end), line_end,
+                       section_token)) {
+      sections.back().body_end = line;
+      sections.back().end = line_end;
+      section_token = nullptr;
+    }
+    line = line_end;
+  }
+  return section_token == nullptr;
+}
+
+// First statement that starts at or after `p`.
+static const char *nextStatement(const char *p, const char *end) {
+  while (p < end) {
+    const char *q = skipBlanks(p, end);
+    if (q + 1 < end && *q == '-' &&
+        std::isspace(static_cast<unsigned char>(q[1])))
+      return p;
+    const void *eol = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    p = eol ? static_cast<const char *>(eol) + 1 : end;
+  }
+  return end;
+}
+
+static void initDefReader(Design *design, bool wiring) {
   defrInit();
   defrSetUserData(design);
+  if (wiring)
+    setWiringCallbacks();
+  defrSetViaCbk(viaCbk);
   defrSetUnitsCbk(dbuCbk);
   defrSetDieAreaCbk(dieAreaCbk);
   defrSetDesignCbk(designCbk);
@@ -145,12 +532,216 @@ int readDefImpl(const std::string &def_file_path, Design *design) {
   defrSetPinCbk(pinCbk);
   defrSetNetCbk(netCbk);
   defrSetTrackCbk(trackCbk);
-  // defrSetGcellGridCbk(gcellGridCbk);
+  defrSetGcellGridCbk(gcellGridCbk);
+  defrSetBlockageCbk(blockageCbk);
+  defrSetSNetStartCbk(specialNetStartCbk);
+  defrSetSNetEndCbk(specialNetEndCbk);
+  defrSetSNetCbk(specialNetCbk);
+  defrSetPathCbk(pathCbk);
+}
+
+// Read with the callbacks that fill `design` directly, from `data` if it
+// is given and from `def_stream` otherwise.
+static int readDefPlain(FILE *def_stream, char *data, size_t size,
+                        const std::string &def_file_path, Design *design,
+                        GuideData *wiring) {
+  DefWiring def_wiring{design->technology(), wiring};
+  t_def_wiring = wiring ? &def_wiring : nullptr;
+  t_in_special_nets = false;
+  initDefReader(design, wiring != nullptr);
+  if (data)
+    defrSetInputBuffer(data, size);
+  int res = defrRead(def_stream, def_file_path.c_str(), design, 1);
+  defrClear();
+  t_def_wiring = nullptr;
+  t_in_special_nets = false;
+  warnUnknownVias(def_wiring.num_unknown_vias, def_file_path);
+  return res;
+}
+
+// The read function of the DEF reader has no user data, so the
+// decompressor of the calling thread is kept here.
+static thread_local GzipReader *t_def_gzip = nullptr;
+
+static size_t readDefGzipData(FILE *, char *buffer, size_t size) {
+  return t_def_gzip->read(buffer, size);
+}
+
+// Read a gzip compressed file, inflated on a background thread while the
+// reader parses what is already inflated.
+static int readDefGzip(const std::string &def_file_path, Design *design,
+                       GuideData *wiring) {
+  GzipReader gzip(def_file_path);
+  if (!gzip.isOpen())
+    return 1;
+  DefWiring def_wiring{design->technology(), wiring};
+  t_def_wiring = wiring ? &def_wiring : nullptr;
+  t_in_special_nets = false;
+  initDefReader(design, wiring != nullptr);
+  t_def_gzip = &gzip;
+  defrSetReadFunction(readDefGzipData);
+  int res = defrRead(nullptr, def_file_path.c_str(), design, 1);
+  t_def_gzip = nullptr;
+  defrClear();
+  t_def_wiring = nullptr;
+  t_in_special_nets = false;
+  warnUnknownVias(def_wiring.num_unknown_vias, def_file_path);
+  if (res == 0 && gzip.failed()) {
+    LOG_ERROR("DEF file `%s` is truncated or corrupt", def_file_path.c_str());
+    res = 1;
+  }
+  return res;
+}
+
+// Sections are split into chunks of at least this size, so that small
+// designs are read by a single reader.
+static constexpr size_t kMinDefChunkBytes = size_t(4) << 20;
+
+static int parseDefBuffer(std::string &buffer, const std::string &def_file_path,
+                          const Technology *tech, bool wiring,
+                          DefStaging *staging) {
+  DefWiring def_wiring{tech, &staging->wiring};
+  t_def_wiring = wiring ? &def_wiring : nullptr;
+  t_in_special_nets = false;
+  defrInit();
+  if (wiring)
+    setWiringCallbacks();
+  defrSetComponentCbk(stageComponentCbk);
+  defrSetNetCbk(stageNetCbk);
+  defrSetInputBuffer(&buffer[0], buffer.size());
+  int res = defrRead(nullptr, def_file_path.c_str(), staging, 1);
+  defrClear();
+  t_def_wiring = nullptr;
+  t_in_special_nets = false;
+  staging->num_unknown_vias = def_wiring.num_unknown_vias;
+  return res;
+}
+
+// Parse the COMPONENTS and NETS sections in chunks on worker threads, and
+// everything else with the plain callbacks. Returns -1 if the file is not
+// worth or not fit for splitting, so that the caller reads it as a whole.
+static int readDefSectioned(const std::string &def_file_path,
+                            const MappedFile &def_map, Design *design,
+                            GuideData *wiring) {
+  if (numThreads() <= 1)
+    return -1;
+  const char *data = def_map.data();
+  const char *end = data + def_map.size();
+  std::vector<DefSection> sections;
+  const char *prologue_end;
+  if (!findDefSections(data, def_map.size(), sections, prologue_end) ||
+      sections.empty())
+    return -1;
+
+  // chunk i holds the statements [chunk_begin[i], chunk_end[i]) of
+  // section chunk_section[i]
+  std::vector<const char *> chunk_begin, chunk_end;
+  std::vector<int> chunk_section;
+  size_t max_chunks = static_cast<size_t>(4 * numThreads());
+  for (size_t s = 0; s < sections.size(); s++) {
+    const DefSection &section = sections[s];
+    size_t bytes = static_cast<size_t>(section.body_end - section.body);
+    size_t num_chunks =
+        std::max<size_t>(1, std::min(bytes / kMinDefChunkBytes, max_chunks));
+    const char *begin = section.body;
+    for (size_t c = 1; c <= num_chunks; c++) {
+      const char *split = c == num_chunks
+                              ? section.body_end
+                              : nextStatement(section.body +
+                                                  bytes * c / num_chunks,
+                                              section.body_end);
+      if (split <= begin)
+        continue;
+      chunk_begin.push_back(begin);
+      chunk_end.push_back(split);
+      chunk_section.push_back(static_cast<int>(s));
+      begin = split;
+    }
+  }
+  if (chunk_begin.size() < 2)
+    return -1;
+
+  // Everything but the sections goes to the plain reader.
+  std::string skeleton;
+  const char *copied = data;
+  for (const auto &section : sections) {
+    skeleton.append(copied, section.begin);
+    copied = section.end;
+  }
+  skeleton.append(copied, end);
+
+  // task 0 reads the skeleton, task i > 0 chunk i - 1. Wiring refers to
+  // the vias of the skeleton, which is then read first.
+  int num_chunks = static_cast<int>(chunk_begin.size());
+  std::vector<DefStaging> stagings(chunk_begin.size());
+  std::vector<int> results(chunk_begin.size() + 1, 0);
+  auto read_skeleton = [&]() {
+    results[0] = readDefPlain(nullptr, &skeleton[0], skeleton.size(),
+                              def_file_path, design, nullptr);
+  };
+  if (wiring)
+    read_skeleton();
+  parallelFor(wiring ? 1 : 0, num_chunks + 1, [&](int i) {
+    if (i == 0) {
+      read_skeleton();
+      return;
+    }
+    size_t c = static_cast<size_t>(i - 1);
+    const DefSection &section =
+        sections[static_cast<size_t>(chunk_section[c])];
+    std::string buffer(data, prologue_end);
+    buffer.append(section.begin, section.body);
+    buffer.append(chunk_begin[c], chunk_end[c]);
+    buffer.append(section.body_end, section.end);
+    buffer.append("\nEND DESIGN\n");
+    results[c + 1] = parseDefBuffer(buffer, def_file_path,
+                                    design->technology(), wiring != nullptr,
+                                    &stagings[c]);
+  });
+  for (int res : results) {
+    if (res)
+      return res;
+  }
+  size_t num_unknown_vias = 0;
+  for (const auto &staging : stagings) {
+    for (const auto &comp : staging.components)
+      makeComponent(comp, design);
+    for (const auto &def_net : staging.nets) {
+      Net *net = makeNet(def_net, design);
+      if (wiring && def_net.wiring_end > def_net.wiring_begin) {
+        const auto &segments = staging.wiring.segments;
+        size_t begin = wiring->segments.size();
+        wiring->segments.insert(
+            wiring->segments.end(),
+            segments.begin() + static_cast<std::ptrdiff_t>(def_net.wiring_begin),
+            segments.begin() + static_cast<std::ptrdiff_t>(def_net.wiring_end));
+        wiring->nets.push_back({net, begin, wiring->segments.size()});
+      }
+    }
+    num_unknown_vias += staging.num_unknown_vias;
+  }
+  warnUnknownVias(num_unknown_vias, def_file_path);
+  return 0;
+}
+
+int readDefImpl(const std::string &def_file_path, Design *design,
+                GuideData *wiring) {
   FILE *def_stream = std::fopen(def_file_path.c_str(), "r");
   if (def_stream == nullptr) {
     return 1;
   }
-  int res = defrRead(def_stream, def_file_path.c_str(), design, 1);
+  int res = -1;
+  if (GzipReader::isGzip(def_file_path)) {
+    res = readDefGzip(def_file_path, design, wiring);
+  } else {
+    // Lex straight from the page cache when possible, stdio otherwise.
+    MappedFile def_map(def_file_path);
+    if (def_map.isMapped())
+      res = readDefSectioned(def_file_path, def_map, design, wiring);
+    if (res < 0)
+      res = readDefPlain(def_stream, def_map.data(), def_map.size(),
+                         def_file_path, design, wiring);
+  }
   std::fclose(def_stream);
   if (res != 0) {
     LOG_ERROR("Error occurred when parsing LEF file. Exit Code: %i", res);
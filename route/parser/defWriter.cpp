@@ -0,0 +1,311 @@
+#include "parser.hpp"
+#include "../object/Design.hpp"
+#include "../util/log.hpp"
+#include "../util/output_buffer.hpp"
+#include "../util/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <defwWriter.hpp>
+#include <memory>
+#include <string_view>
+
+namespace sca {
+
+// The header, components, pins and blockages go through defwWriter into
+// memory. The NETS section, by far the largest part, is formatted by worker
+// threads in the same layout and spliced in before END DESIGN.
+
+static DBU toDbu(double microns, double dbu) {
+  return static_cast<DBU>(std::lround(microns * dbu));
+}
+
+static const char *defDirection(PortDirection dir) {
+  switch (dir) {
+  case PortDirection::Input:
+    return "INPUT";
+  case PortDirection::Output:
+    return "OUTPUT";
+  case PortDirection::Inout:
+    return "INOUT";
+  default:
+    return nullptr;
+  }
+}
+
+static const char *defGridMaster(LayerDirection dir) {
+  return dir == LayerDirection::Vertical ? "X" : "Y";
+}
+
+// Connected ports of the top instance become PINS; DEF has no pins without
+// a net. A port with a single shape is written the plain way, others with
+// one PORT per shape.
+static int writePins(Design *design, size_t &num_skipped) {
+  Instance *top = design->topInstance();
+  Libcell *libcell = top->libcell();
+  double dbu = design->dbu();
+  std::vector<std::pair<Port *, const Net *>> pins;
+  for (int i = 0; i < libcell->numPorts(); i++) {
+    Port *port = libcell->port(static_cast<size_t>(i));
+    Pin *pin = top->findPin(port->name());
+    if (pin && pin->net())
+      pins.emplace_back(port, pin->net());
+  }
+  num_skipped = static_cast<size_t>(libcell->numPorts()) - pins.size();
+  int res = defwStartPins(static_cast<int>(pins.size()));
+  for (const auto &[port, net] : pins) {
+    const std::string &net_name = net->name();
+    const char *dir = defDirection(port->direction());
+    std::vector<std::pair<const Layer *, BoxT<DBU>>> shapes;
+    for (int j = 0; j < port->numShapes(); j++) {
+      const auto &[layer, box] = port->shape(static_cast<size_t>(j));
+      if (layer)
+        shapes.emplace_back(layer, BoxT<DBU>(toDbu(box.lx(), dbu),
+                                             toDbu(box.ly(), dbu),
+                                             toDbu(box.hx(), dbu),
+                                             toDbu(box.hy(), dbu)));
+    }
+    if (shapes.size() == 1) {
+      const auto &[layer, box] = shapes[0];
+      res |= defwPin(port->name().c_str(), net_name.c_str(), 0, dir, nullptr,
+                     "FIXED", box.lx(), box.ly(), 0, layer->name().c_str(), 0,
+                     0, box.hx() - box.lx(), box.hy() - box.ly());
+      continue;
+    }
+    res |= defwPin(port->name().c_str(), net_name.c_str(), 0, dir, nullptr,
+                   nullptr, 0, 0, -1, nullptr, 0, 0, 0, 0);
+    for (const auto &[layer, box] : shapes) {
+      res |= defwPinPort();
+      res |= defwPinPortLayer(layer->name().c_str(), 0, 0, 0, 0,
+                              box.hx() - box.lx(), box.hy() - box.ly());
+      res |= defwPinPortLocation("FIXED", box.lx(), box.ly(), "N");
+    }
+  }
+  return res | defwEndPins();
+}
+
+// Write everything but the nets into `file`, with `nets_offset` set to where
+// the NETS section belongs. Returns non-zero if defwWriter failed.
+static int writeDefSkeleton(FILE *file, Design *design, size_t &nets_offset,
+                            size_t &num_skipped, size_t &num_skipped_pins) {
+  int res = defwInit(file, 5, 8, nullptr, "/", "[]", design->name().c_str(),
+                     nullptr, nullptr, nullptr, design->dbu());
+  const BoxT<DBU> &die = design->dieBox();
+  res |= defwDieArea(die.lx(), die.ly(), die.hx(), die.hy());
+  for (const TrackConfig &tc : design->trackConfigs()) {
+    const char *layer_name = tc.layer->name().c_str();
+    res |= defwTracks(defGridMaster(tc.layer->direction()), tc.start, tc.count,
+                      tc.step, 1, &layer_name);
+  }
+  for (const GridConfig &gc : design->gridConfigs())
+    res |= defwGcellGrid(defGridMaster(gc.direction), gc.start, gc.count,
+                         gc.step);
+
+  // instances of unknown macros can not be written
+  int num_components = 0;
+  for (int i = 0; i < design->numInstances(); i++)
+    num_components += design->instance(i)->libcell() != nullptr;
+  num_skipped = static_cast<size_t>(design->numInstances() - num_components);
+  res |= defwStartComponents(num_components);
+  for (int i = 0; i < design->numInstances(); i++) {
+    Instance *inst = design->instance(i);
+    if (inst->libcell() == nullptr)
+      continue;
+    res |= defwComponent(inst->name().c_str(),
+                         inst->libcell()->name().c_str(), 0, nullptr, nullptr,
+                         nullptr, nullptr, nullptr, 0, nullptr, nullptr,
+                         nullptr, nullptr, "PLACED", inst->lx(), inst->ly(),
+                         static_cast<int>(inst->orientation()), 0, nullptr, 0,
+                         0, 0, 0);
+  }
+  res |= defwEndComponents();
+  res |= writePins(design, num_skipped_pins);
+
+  // special net shapes are kept as obstructions only
+  const auto &obstructions = design->obstructions();
+  if (!obstructions.empty()) {
+    res |= defwStartBlockages(static_cast<int>(obstructions.size()));
+    for (const auto &[layer, box] : obstructions) {
+      res |= defwBlockagesLayer(layer->name().c_str());
+      res |= defwBlockagesRect(box.lx(), box.ly(), box.hx(), box.hy());
+    }
+    res |= defwEndBlockages();
+  }
+  std::fflush(file);
+  nets_offset = static_cast<size_t>(std::ftell(file));
+  return res | defwEnd();
+}
+
+struct DefNetFormat {
+  const Grid *grid; // null to write the connections only
+  std::vector<std::string_view> layer_names;
+  std::vector<std::string_view> via_names; // by cut layer, empty if unknown
+};
+
+static void appendPoint(std::string &out, const PointOnLayerT<int> &p) {
+  out += " ( ";
+  appendInt(out, p.x);
+  out += ' ';
+  appendInt(out, p.y);
+  out += " )";
+}
+
+// Same as appendPoint, with `*` for the coordinates that stay the same.
+static void appendNextPoint(std::string &out, const PointOnLayerT<int> &prev,
+                            const PointOnLayerT<int> &p) {
+  out += " ( ";
+  if (p.x == prev.x)
+    out += '*';
+  else
+    appendInt(out, p.x);
+  out += ' ';
+  if (p.y == prev.y)
+    out += '*';
+  else
+    appendInt(out, p.y);
+  out += " )";
+}
+
+// Each tree edge becomes a path between gcell centers; an edge between
+// layers becomes one via per cut layer it crosses.
+static void appendRoute(std::string &out, const DefNetFormat &format,
+                        const std::shared_ptr<GRTreeNode> &tree,
+                        size_t &num_missing_vias) {
+  bool first = true;
+  auto start_path = [&](int layer_idx, const PointOnLayerT<int> &p) {
+    out += first ? "\n      + ROUTED " : "\n         NEW ";
+    first = false;
+    appendWord(out, format.layer_names[static_cast<size_t>(layer_idx)]);
+    appendPoint(out, p);
+  };
+  GRTreeNode::preorder(tree, [&](std::shared_ptr<GRTreeNode> node) {
+    PointOnLayerT<int> p = format.grid->gcellToDbu(*node);
+    for (const auto &child : node->children) {
+      PointOnLayerT<int> q = format.grid->gcellToDbu(*child);
+      if (node->layerIdx == child->layerIdx) {
+        start_path(node->layerIdx, p);
+        appendNextPoint(out, p, q);
+        continue;
+      }
+      int low = std::min(node->layerIdx, child->layerIdx);
+      int high = std::max(node->layerIdx, child->layerIdx);
+      for (int z = low; z < high; z++) {
+        std::string_view via = format.via_names[static_cast<size_t>(z)];
+        if (via.empty()) {
+          num_missing_vias++;
+          continue;
+        }
+        start_path(z, p);
+        out += ' ';
+        appendWord(out, via);
+      }
+    }
+  });
+}
+
+// Connections to instances of unknown macros are left out like the
+// instances themselves.
+static void appendNets(std::string &out, Design *design,
+                       const DefNetFormat &format, int begin, int end,
+                       size_t &num_missing_vias, size_t &num_skipped) {
+  Instance *top = design->topInstance();
+  for (int i = begin; i < end; i++) {
+    Net *net = design->net(i);
+    out += "   - ";
+    appendWord(out, net->name());
+    int num_written = 0;
+    for (int j = 0; j < net->numPins(); j++) {
+      Pin *pin = net->pin(j);
+      if (pin->instance() != top && pin->instance()->libcell() == nullptr) {
+        num_skipped++;
+        continue;
+      }
+      if (num_written > 0 && num_written % 4 == 0)
+        out += "\n     ";
+      num_written++;
+      out += " ( ";
+      appendWord(out, pin->instance() == top ? "PIN" : pin->instance()->name());
+      out += ' ';
+      appendWord(out, pin->name());
+      out += " )";
+    }
+    if (format.grid && net->routingTree())
+      appendRoute(out, format, net->routingTree(), num_missing_vias);
+    out += " ;\n";
+  }
+}
+
+int writeDefImpl(const std::string &def_file_path, Design *design,
+                 bool routes) {
+  char *skeleton_data = nullptr;
+  size_t skeleton_size = 0;
+  FILE *skeleton_file = open_memstream(&skeleton_data, &skeleton_size);
+  if (skeleton_file == nullptr) {
+    LOG_ERROR("can not write file %s", def_file_path.c_str());
+    return 1;
+  }
+  size_t nets_offset = 0, num_skipped = 0, num_skipped_pins = 0;
+  int res = writeDefSkeleton(skeleton_file, design, nets_offset, num_skipped,
+                             num_skipped_pins);
+  std::fclose(skeleton_file);
+  std::unique_ptr<char, decltype(&std::free)> skeleton_owner(skeleton_data,
+                                                             &std::free);
+  if (res) {
+    LOG_ERROR("can not write design %s to DEF", design->name().c_str());
+    return 1;
+  }
+  if (num_skipped_pins > 0)
+    LOG_WARN("%zu ports without a net are not written to %s",
+             num_skipped_pins, def_file_path.c_str());
+
+  Technology *tech = design->technology();
+  DefNetFormat format;
+  format.grid = routes ? design->grid() : nullptr;
+  for (int i = 0; i < tech->numLayers(); i++)
+    format.layer_names.push_back(tech->layer(i)->name());
+  for (int i = 0; i < tech->numCutLayers(); i++)
+    format.via_names.push_back(tech->cutLayer(i)->viaName());
+
+  int num_nets = design->numNets();
+  int num_parts = std::max(1, std::min(4 * numThreads(), num_nets));
+  std::vector<std::string> parts(static_cast<size_t>(num_parts));
+  std::vector<size_t> missing_vias(static_cast<size_t>(num_parts), 0);
+  std::vector<size_t> skipped_conns(static_cast<size_t>(num_parts), 0);
+  parallelFor(0, num_parts, [&](int t) {
+    int begin = static_cast<int>(static_cast<long long>(num_nets) * t / num_parts);
+    int end = static_cast<int>(static_cast<long long>(num_nets) * (t + 1) / num_parts);
+    appendNets(parts[static_cast<size_t>(t)], design, format, begin, end,
+               missing_vias[static_cast<size_t>(t)],
+               skipped_conns[static_cast<size_t>(t)]);
+  });
+  size_t num_missing_vias = 0, num_skipped_conns = 0;
+  for (int t = 0; t < num_parts; t++) {
+    num_missing_vias += missing_vias[static_cast<size_t>(t)];
+    num_skipped_conns += skipped_conns[static_cast<size_t>(t)];
+  }
+  if (num_skipped > 0)
+    LOG_WARN("%zu instances of unknown macros and their %zu connections are "
+             "not written to %s",
+             num_skipped, num_skipped_conns, def_file_path.c_str());
+  if (num_missing_vias > 0)
+    LOG_WARN("%zu vias of cut layers without a LEF via are not written to %s",
+             num_missing_vias, def_file_path.c_str());
+
+  std::string_view skeleton(skeleton_data, skeleton_size);
+  std::string nets_begin = "NETS ", nets_end = "END NETS\n\n";
+  appendInt(nets_begin, num_nets);
+  nets_begin += " ;\n";
+  std::vector<std::string_view> buffers = {skeleton.substr(0, nets_offset),
+                                           nets_begin};
+  buffers.insert(buffers.end(), parts.begin(), parts.end());
+  buffers.push_back(nets_end);
+  buffers.push_back(skeleton.substr(nets_offset));
+  if (!writeBuffers(def_file_path, buffers)) {
+    LOG_ERROR("can not write file %s", def_file_path.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace sca
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "../object/Route.hpp"
+#include <string>
+#include <vector>
+
+namespace sca {
+
+class Design;
+class Net;
+
+// The segments of the nets listed in a guide, in gcells, shared by the guide
+// readers and writers. A net listed more than once has several entries.
+struct GuideNet {
+  Net *net;
+  size_t begin, end; // range in GuideData::segments
+};
+
+struct GuideData {
+  std::vector<RouteSegment<int>> segments;
+  std::vector<GuideNet> nets;
+};
+
+// Parse a text guide, optionally gzip compressed, or a binary guide.
+void parseGuide(const std::string &guide_file_path, Design *design,
+                GuideData &data);
+
+} // namespace sca
@@ -1,88 +1,381 @@
 #include "parser.hpp"
+#include "binaryGuide.hpp"
+#include "guide.hpp"
 #include "../object/Design.hpp"
+#include "../util/gzip_reader.hpp"
 #include "../util/log.hpp"
-#include <fstream>
+#include "../util/mapped_file.hpp"
+#include "../util/parallel.hpp"
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
 
 namespace sca {
 
-int readGuideImpl(const std::string &guide_file_path, Design *design) {
-  Technology *tech = design->technology();
-
-  std::ifstream fin(guide_file_path);
-  ASSERT(!!fin, "Cound not open GUIDE file `%s`", guide_file_path.c_str());
-  std::string line;
-  Net *net = nullptr;
-  std::vector<RouteSegment<int>> net_route;
-  while (fin.good()) {
-    std::getline(fin, line);
-    std::vector<std::string> words;
-    {
-      size_t last = 0;
-      last = line.find_first_not_of(' ');
-      size_t next = last;
-      while ((next = line.find_first_of(' ', last)) != std::string::npos) {
-        words.push_back(line.substr(last, next - last));
-        last = line.find_first_not_of(' ', next);
-      }
-      if (last < line.size()) {
-        words.push_back(line.substr(last, std::string::npos));
-      }
-    }
+// A guide file lists the routing segments of each net:
+//
+//   net_name
+//   (
+//   x0 y0 layer0 x1 y1 layer1
+//   ...
+//   )
+//
+// The input is scanned in place, without copying lines or words out of it.
+// Nets are only collected while parsing. Their trees are built afterwards in
+// parallel.
+struct GuideParser {
+  const std::string *path;
+  Design *design;
+  Technology *tech;
+  Grid *grid;
+  // layer names by index, and a table from the hash of a name to its index
+  // (-1 for no layer, -2 for several)
+  std::vector<std::string_view> layer_names;
+  std::array<int, 256> layer_slots;
+  GuideData *data;
+  Net *net = nullptr; // net being parsed, and its first segment
+  size_t net_begin = 0;
+};
 
-    if (words.size() == 0 || (words.size() == 1 && words[0] == "("))
-      continue;
-    else if (words.size() == 1 && words[0] == ")") {
-      auto tree = buildTree(net_route, tech);
-      net->setRoutingTree(tree);
-      // precompute access points
-      std::vector<std::vector<sca::PointOnLayerT<int>>> access_points_per_pin(net->numPins());
-      for (int j = 0; j < net->numPins(); j++) {
-        Pin *pin = net->pin(j);
-        design->grid()->computeAccessPoints(pin, access_points_per_pin[j]);
-      }
-      // check end points
-      for (int j = 0; j < net->numPins(); j++) {
-        Pin *pin = net->pin(j);
-        const auto &access_points = access_points_per_pin[j];
-        for (size_t k = 0; k < access_points.size(); k++) {
-          const auto &ap = access_points[k];
-          if (ap.x == tree->x && ap.y == tree->y && ap.layerIdx == tree->layerIdx)
-            pin->setPosition(ap);
+static size_t layerSlot(std::string_view name) {
+  return (name.size() * 31 + static_cast<unsigned char>(name.back()) * 7 +
+          static_cast<unsigned char>(name[name.size() / 2])) %
+         256;
+}
+
+static void initGuideParser(GuideParser &parser,
+                            const std::string &guide_file_path,
+                            Design *design, GuideData &data) {
+  parser.path = &guide_file_path;
+  parser.design = design;
+  parser.data = &data;
+  parser.tech = design->technology();
+  parser.grid = design->grid();
+  parser.layer_slots.fill(-1);
+  for (int i = 0; i < parser.tech->numLayers(); i++) {
+    std::string_view name = parser.tech->layer(i)->name();
+    parser.layer_names.push_back(name);
+    int &slot = parser.layer_slots[layerSlot(name)];
+    slot = slot == -1 ? i : -2;
+  }
+}
+
+// Key of a gcell for the access point table of a net. Access points are
+// never negative.
+static uint64_t accessPointKey(int layer_idx, int x, int y) {
+  return static_cast<uint64_t>(layer_idx) << 48 |
+         static_cast<uint64_t>(x) << 24 | static_cast<uint64_t>(y);
+}
+
+// Sets the position of each pin to one of its access points on the tree. As
+// before, the last hit wins: hits on edges in preorder override hits on the
+// root, and within an edge the largest access point does.
+static void matchPins(Grid *grid, Net *net,
+                      std::shared_ptr<GRTreeNode> tree) {
+  struct AccessPoint {
+    PointOnLayerT<int> point;
+    int pin, k; // k-th access point of the pin
+  };
+  std::vector<AccessPoint> access_points;
+  std::vector<size_t> pin_begin; // first access point of each pin
+  std::vector<PointOnLayerT<int>> pin_access_points;
+  for (int j = 0; j < net->numPins(); j++) {
+    pin_begin.push_back(access_points.size());
+    pin_access_points.clear();
+    grid->computeAccessPoints(net->pin(j), pin_access_points);
+    for (size_t k = 0; k < pin_access_points.size(); k++)
+      access_points.push_back({pin_access_points[k], j, static_cast<int>(k)});
+  }
+  std::unordered_multimap<uint64_t, size_t> access_point_index;
+  access_point_index.reserve(access_points.size());
+  for (size_t i = 0; i < access_points.size(); i++) {
+    const auto &ap = access_points[i].point;
+    access_point_index.emplace(accessPointKey(ap.layerIdx, ap.x, ap.y), i);
+  }
+
+  // hit of each pin: index of the edge (-1 for the root) and access point
+  std::vector<std::pair<int, int>> hits(static_cast<size_t>(net->numPins()),
+                                        {-2, -1});
+  auto hit = [&](int edge, const AccessPoint &ap) {
+    auto &pin_hit = hits[static_cast<size_t>(ap.pin)];
+    if (pin_hit.first < edge || (pin_hit.first == edge && pin_hit.second < ap.k))
+      pin_hit = {edge, ap.k};
+  };
+  for (const auto &ap : access_points) {
+    if (ap.point == *tree)
+      hit(-1, ap);
+  }
+  int edge = 0;
+  GRTreeNode::preorder(tree, [&](std::shared_ptr<GRTreeNode> node) {
+    for (const auto &child : node->children) {
+      auto [init_x, final_x] = std::minmax(node->x, child->x);
+      auto [init_y, final_y] = std::minmax(node->y, child->y);
+      auto [init_z, final_z] = std::minmax(node->layerIdx, child->layerIdx);
+      size_t num_gcells = static_cast<size_t>(final_x - init_x + 1) *
+                          static_cast<size_t>(final_y - init_y + 1) *
+                          static_cast<size_t>(final_z - init_z + 1);
+      if (num_gcells > access_points.size()) {
+        // long edges: test each access point instead
+        for (const auto &ap : access_points) {
+          if (init_x <= ap.point.x && ap.point.x <= final_x &&
+              init_y <= ap.point.y && ap.point.y <= final_y &&
+              init_z <= ap.point.layerIdx && ap.point.layerIdx <= final_z)
+            hit(edge, ap);
         }
-      }
-      // check itermediate points
-      GRTreeNode::preorder(tree, [&](std::shared_ptr<GRTreeNode> node) {
-        for (const auto &child : node->children) {
-          for (int j = 0; j < net->numPins(); j++) {
-            Pin *pin = net->pin(j);
-            // compute local access_points
-            const auto &access_points = access_points_per_pin[j];
-            for (size_t k = 0; k < access_points.size(); k++) {
-              const auto &ap = access_points[k];
-              auto [init_x, final_x] = std::minmax(node->x, child->x);
-              auto [init_y, final_y] = std::minmax(node->y, child->y);
-              auto [init_z, final_z] =
-                std::minmax(node->layerIdx, child->layerIdx);
-              if (init_x <= ap.x && ap.x <= final_x && init_y <= ap.y &&
-                ap.y <= final_y && init_z <= ap.layerIdx &&
-                ap.layerIdx <= final_z)
-                pin->setPosition(ap);
+      } else {
+        for (int z = std::max(init_z, 0); z <= final_z; z++) {
+          for (int x = std::max(init_x, 0); x <= final_x; x++) {
+            for (int y = std::max(init_y, 0); y <= final_y; y++) {
+              auto range = access_point_index.equal_range(accessPointKey(z, x, y));
+              for (auto it = range.first; it != range.second; ++it)
+                hit(edge, access_points[it->second]);
             }
           }
         }
-      });
-    } else if (words.size() == 1) {
-      net = design->findNet(words[0]);
-      ASSERT(net, "Cound file NET `%s`", words[0].c_str());
-      net_route.clear();
+      }
+      edge++;
+    }
+  });
+
+  for (int j = 0; j < net->numPins(); j++) {
+    const auto &pin_hit = hits[static_cast<size_t>(j)];
+    if (pin_hit.first >= -1) {
+      size_t i = pin_begin[static_cast<size_t>(j)] +
+                 static_cast<size_t>(pin_hit.second);
+      net->pin(j)->setPosition(access_points[i].point);
+    }
+  }
+}
+
+// Builds the tree of the net from its segments and places its pins.
+static void processGuideNet(Design *design, const GuideData &data,
+                            const GuideNet &guide_net) {
+  std::vector<RouteSegment<int>> segments(
+      data.segments.begin() + static_cast<std::ptrdiff_t>(guide_net.begin),
+      data.segments.begin() + static_cast<std::ptrdiff_t>(guide_net.end));
+  auto tree = buildTree(std::move(segments), design->technology());
+  guide_net.net->setRoutingTree(tree);
+  if (tree)
+    matchPins(design->grid(), guide_net.net, tree);
+}
+
+static int findGuideLayer(const GuideParser &parser, std::string_view name) {
+  if (!name.empty()) {
+    int slot = parser.layer_slots[layerSlot(name)];
+    if (slot >= 0 && parser.layer_names[static_cast<size_t>(slot)] == name)
+      return slot;
+    if (slot == -2) {
+      for (size_t i = 0; i < parser.layer_names.size(); i++) {
+        if (parser.layer_names[i] == name)
+          return static_cast<int>(i);
+      }
+    }
+  }
+  PANIC("Could not find layer `%.*s` of GUIDE file `%s`",
+        static_cast<int>(name.size()), name.data(), parser.path->c_str());
+}
+
+// Cursor over the lines of a guide file.
+struct GuideScanner {
+  const char *p;
+  const char *end;
+
+  void skipBlanks() {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+      p++;
+  }
+  std::string_view word() {
+    skipBlanks();
+    const char *begin = p;
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+      p++;
+    return std::string_view(begin, static_cast<size_t>(p - begin));
+  }
+  // a coordinate is always followed by another word on the same line
+  bool coordinate(int &value) {
+    skipBlanks();
+    auto [last, ec] = std::from_chars(p, end, value);
+    if (ec != std::errc() || last == end || (*last != ' ' && *last != '\t'))
+      return false;
+    p = last;
+    return true;
+  }
+  bool endOfLine() {
+    skipBlanks();
+    if (p == end)
+      return true;
+    if (*p != '\n')
+      return false;
+    p++;
+    return true;
+  }
+};
+
+static void parseGuideSegment(GuideParser &parser, GuideScanner &scanner,
+                              int x0) {
+  int y0, x1, y1;
+  bool valid = scanner.coordinate(y0);
+  std::string_view layer0 = valid ? scanner.word() : std::string_view();
+  valid = valid && scanner.coordinate(x1) && scanner.coordinate(y1);
+  std::string_view layer1 = valid ? scanner.word() : std::string_view();
+  ASSERT(valid && scanner.endOfLine(), "Invalid segment in GUIDE file `%s`",
+         parser.path->c_str());
+  PointOnLayerT<int> p(findGuideLayer(parser, layer0), x0, y0);
+  PointOnLayerT<int> q(findGuideLayer(parser, layer1), x1, y1);
+  parser.data->segments.emplace_back(parser.grid->dbuToGcell(p),
+                                     parser.grid->dbuToGcell(q));
+}
+
+// Parse the lines of [begin, end).
+static void parseGuideLines(GuideParser &parser, const char *begin,
+                            const char *end) {
+  GuideScanner scanner{begin, end};
+  while (scanner.p < end) {
+    // segments start with a coordinate, anything else is a single word
+    const char *line = scanner.p;
+    int x0;
+    if (scanner.coordinate(x0)) {
+      parseGuideSegment(parser, scanner, x0);
+      continue;
+    }
+    scanner.p = line;
+    std::string_view word = scanner.word();
+    ASSERT(scanner.endOfLine(), "Invalid line `%.*s` in GUIDE file `%s`",
+           static_cast<int>(word.size()), word.data(), parser.path->c_str());
+    if (word.empty() || word == "(")
+      continue;
+    if (word == ")") {
+      ASSERT(parser.net, "Missing NET in GUIDE file `%s`",
+             parser.path->c_str());
+      parser.data->nets.push_back(
+          {parser.net, parser.net_begin, parser.data->segments.size()});
     } else {
-      PointOnLayerT<int> p(tech->findLayer(words[2])->idx(), std::stoi(words[0]), std::stoi(words[1]));
-      PointOnLayerT<int> q(tech->findLayer(words[5])->idx(), std::stoi(words[3]), std::stoi(words[4]));
-      p = design->grid()->dbuToGcell(p);
-      q = design->grid()->dbuToGcell(q);
-      net_route.emplace_back(p, q);
+      parser.net = parser.design->findNet(std::string(word));
+      ASSERT(parser.net, "Cound file NET `%.*s`",
+             static_cast<int>(word.size()), word.data());
+      parser.net_begin = parser.data->segments.size();
+    }
+  }
+}
+
+// Nets are independent of each other, except that a net listed more than
+// once keeps the result of its last listing. The listings of such a net are
+// processed in file order by the same task.
+static void processGuideNets(Design *design, const GuideData &data) {
+  const size_t none = data.nets.size();
+  std::vector<size_t> tasks, next(data.nets.size(), none);
+  std::unordered_map<Net *, size_t> last_of_net;
+  last_of_net.reserve(data.nets.size());
+  for (size_t i = 0; i < data.nets.size(); i++) {
+    auto [it, inserted] = last_of_net.emplace(data.nets[i].net, i);
+    if (inserted) {
+      tasks.push_back(i);
+    } else {
+      next[it->second] = i;
+      it->second = i;
+    }
+  }
+  parallelFor(0, static_cast<int>(tasks.size()), [&](int t) {
+    for (size_t i = tasks[static_cast<size_t>(t)]; i != none; i = next[i])
+      processGuideNet(design, data, data.nets[i]);
+  });
+}
+
+// Binary guides store gcells, so the grid has to match. Layers are matched
+// by name.
+static void parseBinaryGuide(GuideParser &parser) {
+  BinaryGuide guide(*parser.path);
+  ASSERT(guide.isOpen(), "Invalid or unsupported binary GUIDE file `%s`",
+         parser.path->c_str());
+  ASSERT(guide.sizeX() == parser.grid->sizeX() &&
+             guide.sizeY() == parser.grid->sizeY(),
+         "GUIDE file `%s` was written for a %d x %d gcell grid, not %d x %d",
+         parser.path->c_str(), guide.sizeX(), guide.sizeY(),
+         parser.grid->sizeX(), parser.grid->sizeY());
+  std::vector<int> layers;
+  for (int i = 0; i < guide.numLayers(); i++)
+    layers.push_back(findGuideLayer(parser, guide.layerName(i)));
+
+  GuideData &data = *parser.data;
+  for (size_t i = 0; i < guide.numNets(); i++) {
+    std::string_view name = guide.netName(i);
+    Net *net = parser.design->findNet(std::string(name));
+    ASSERT(net, "Cound file NET `%.*s`", static_cast<int>(name.size()),
+           name.data());
+    size_t begin = data.segments.size();
+    ASSERT(guide.readNet(i, data.segments),
+           "Corrupt NET `%.*s` in GUIDE file `%s`",
+           static_cast<int>(name.size()), name.data(), parser.path->c_str());
+    for (size_t j = begin; j < data.segments.size(); j++) {
+      auto [p, q] = data.segments[j];
+      p.layerIdx = layers[static_cast<size_t>(p.layerIdx)];
+      q.layerIdx = layers[static_cast<size_t>(q.layerIdx)];
+      data.segments[j] = RouteSegment<int>(p, q);
     }
+    data.nets.push_back({net, begin, data.segments.size()});
   }
+}
+
+void parseGuide(const std::string &guide_file_path, Design *design,
+                GuideData &data) {
+  GuideParser parser;
+  initGuideParser(parser, guide_file_path, design, data);
+
+  if (BinaryGuide::isBinaryGuide(guide_file_path)) {
+    parseBinaryGuide(parser);
+    return;
+  }
+
+  MappedFile guide_map(guide_file_path);
+  if (guide_map.isMapped() && !GzipReader::isGzip(guide_file_path)) {
+    parseGuideLines(parser, guide_map.data(),
+                    guide_map.data() + guide_map.size());
+    return;
+  }
+
+  // Compressed guides are parsed block by block as they are inflated. The
+  // incomplete last line of a block is carried over to the next one.
+  GzipReader gzip(guide_file_path);
+  ASSERT(gzip.isOpen(), "Cound not open GUIDE file `%s`",
+         guide_file_path.c_str());
+  std::vector<char> buffer(size_t(1) << 20);
+  size_t carried = 0;
+  for (;;) {
+    if (carried == buffer.size())
+      buffer.resize(2 * buffer.size());
+    size_t n = gzip.read(buffer.data() + carried, buffer.size() - carried);
+    const char *end = buffer.data() + carried + n;
+    if (n == 0) {
+      parseGuideLines(parser, buffer.data(), end);
+      break;
+    }
+    const char *rest = end;
+    while (rest > buffer.data() && rest[-1] != '\n')
+      rest--;
+    parseGuideLines(parser, buffer.data(), rest);
+    carried = static_cast<size_t>(end - rest);
+    std::memmove(buffer.data(), rest, carried);
+  }
+  ASSERT(!gzip.failed(), "GUIDE file `%s` is truncated or corrupt",
+         guide_file_path.c_str());
+}
+
+int readGuideImpl(const std::string &guide_file_path, Design *design) {
+  GuideData data;
+  parseGuide(guide_file_path, design, data);
+  processGuideNets(design, data);
+  return 0;
+}
+
+int makeRoutingTreesImpl(Design *design, GuideData &wiring) {
+  const Grid *grid = design->grid();
+  for (auto &segment : wiring.segments)
+    segment = RouteSegment<int>(grid->dbuToGcell(segment.start),
+                                grid->dbuToGcell(segment.end));
+  processGuideNets(design, wiring);
   return 0;
 }
 
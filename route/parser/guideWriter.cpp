@@ -0,0 +1,162 @@
+#include "parser.hpp"
+#include "binaryGuide.hpp"
+#include "guide.hpp"
+#include "../object/Design.hpp"
+#include "../util/log.hpp"
+#include "../util/output_buffer.hpp"
+#include "../util/parallel.hpp"
+#include <string_view>
+
+namespace sca {
+
+// Collect the edges of the routing trees of nets [begin, end) of the nets to
+// route. A tree without edges is written as a via to the layer above.
+// RouteSegment orders the ends of an edge per axis, so a via goes up from
+// `start` whichever way the tree edge points, and both writers get the same
+// segments.
+static void guideFromTrees(Design *design, int begin, int end,
+                           GuideData &data) {
+  const std::vector<int> &net_indices = design->netIndicesToRoute();
+  for (int i = begin; i < end; i++) {
+    Net *net = design->net(net_indices[static_cast<size_t>(i)]);
+    const auto &tree = net->routingTree();
+    if (tree == nullptr)
+      continue;
+    size_t first = data.segments.size();
+    if (tree->children.size() == 0) {
+      // TODO: check layer index
+      data.segments.emplace_back(
+          *tree, PointOnLayerT<int>(tree->layerIdx + 1, tree->x, tree->y));
+    } else {
+      GRTreeNode::preorder(tree, [&](std::shared_ptr<GRTreeNode> node) {
+        for (const auto &child : node->children)
+          data.segments.emplace_back(*node, *child);
+      });
+    }
+    data.nets.push_back({net, first, data.segments.size()});
+  }
+}
+
+// Format nets [begin, end) of `data` the way read_guide expects them. Vias
+// are split into one segment per cut, from the lower end of the ordered
+// segment up, and gcells are written at their center.
+static void appendGuideText(std::string &out, const GuideData &data,
+                            size_t begin, size_t end, const Grid *grid,
+                            const std::vector<std::string_view> &layer_names) {
+  auto append_segment = [&](const PointOnLayerT<int> &p,
+                            const PointOnLayerT<int> &q) {
+    appendInt(out, p.x);
+    out += ' ';
+    appendInt(out, p.y);
+    out += ' ';
+    appendWord(out, layer_names[static_cast<size_t>(p.layerIdx)]);
+    out += ' ';
+    appendInt(out, q.x);
+    out += ' ';
+    appendInt(out, q.y);
+    out += ' ';
+    appendWord(out, layer_names[static_cast<size_t>(q.layerIdx)]);
+    out += '\n';
+  };
+  for (size_t i = begin; i < end; i++) {
+    const GuideNet &guide_net = data.nets[i];
+    appendWord(out, guide_net.net->name());
+    out += "\n(\n";
+    for (size_t j = guide_net.begin; j < guide_net.end; j++) {
+      const auto &[p, q] = data.segments[j];
+      if (p.layerIdx != q.layerIdx) {
+        PointOnLayerT<int> center = grid->gcellToDbu(p);
+        for (int z = p.layerIdx; z < q.layerIdx; z++)
+          append_segment(PointOnLayerT<int>(z, center.x, center.y),
+                         PointOnLayerT<int>(z + 1, center.x, center.y));
+      } else {
+        append_segment(grid->gcellToDbu(p), grid->gcellToDbu(q));
+      }
+    }
+    out += ")\n";
+  }
+}
+
+static std::vector<std::string_view> guideLayerNames(Design *design) {
+  const Technology *tech = design->technology();
+  std::vector<std::string_view> layer_names;
+  for (int i = 0; i < tech->numLayers(); i++)
+    layer_names.push_back(tech->layer(i)->name());
+  return layer_names;
+}
+
+static bool writeBinaryGuide(const std::string &guide_file_path,
+                             Design *design,
+                             const std::vector<GuideData> &ranges) {
+  BinaryGuideWriter writer(guideLayerNames(design), design->grid()->sizeX(),
+                           design->grid()->sizeY());
+  for (const GuideData &data : ranges) {
+    for (const GuideNet &guide_net : data.nets)
+      writer.addNet(guide_net.net->name(),
+                    data.segments.data() + guide_net.begin,
+                    data.segments.data() + guide_net.end);
+  }
+  return writer.write(guide_file_path);
+}
+
+// Each thread formats a contiguous range of nets into its own buffer.
+static bool writeTextGuide(const std::string &guide_file_path,
+                           Design *design,
+                           const std::vector<GuideData> &ranges) {
+  struct Task {
+    const GuideData *data;
+    size_t begin, end;
+  };
+  std::vector<Task> tasks;
+  size_t parts_per_range =
+      std::max<size_t>(1, static_cast<size_t>(numThreads()) / ranges.size());
+  for (const GuideData &data : ranges) {
+    size_t num_nets = data.nets.size();
+    for (size_t k = 0; k < parts_per_range; k++)
+      tasks.push_back({&data, num_nets * k / parts_per_range,
+                       num_nets * (k + 1) / parts_per_range});
+  }
+  std::vector<std::string_view> layer_names = guideLayerNames(design);
+  std::vector<std::string> buffers(tasks.size());
+  parallelFor(0, static_cast<int>(tasks.size()), [&](int t) {
+    const Task &task = tasks[static_cast<size_t>(t)];
+    appendGuideText(buffers[static_cast<size_t>(t)], *task.data, task.begin,
+                    task.end, design->grid(), layer_names);
+  });
+  return writeBuffers(guide_file_path, buffers);
+}
+
+int writeGuideImpl(const std::string &guide_file_path, Design *design,
+                   bool binary) {
+  int num_nets = static_cast<int>(design->netIndicesToRoute().size());
+  int num_ranges = std::max(1, std::min(numThreads(), num_nets));
+  std::vector<GuideData> ranges(static_cast<size_t>(num_ranges));
+  parallelFor(0, num_ranges, [&](int r) {
+    int begin = static_cast<int>(static_cast<long long>(num_nets) * r / num_ranges);
+    int end = static_cast<int>(static_cast<long long>(num_nets) * (r + 1) / num_ranges);
+    guideFromTrees(design, begin, end, ranges[static_cast<size_t>(r)]);
+  });
+  bool ok = binary ? writeBinaryGuide(guide_file_path, design, ranges)
+                   : writeTextGuide(guide_file_path, design, ranges);
+  if (!ok) {
+    LOG_ERROR("can not write file %s", guide_file_path.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+int convertGuideImpl(const std::string &in_file_path,
+                     const std::string &out_file_path, Design *design) {
+  bool binary = BinaryGuide::isBinaryGuide(in_file_path);
+  std::vector<GuideData> ranges(1);
+  parseGuide(in_file_path, design, ranges[0]);
+  bool ok = binary ? writeTextGuide(out_file_path, design, ranges)
+                   : writeBinaryGuide(out_file_path, design, ranges);
+  if (!ok) {
+    LOG_ERROR("can not write file %s", out_file_path.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace sca
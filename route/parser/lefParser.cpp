@@ -1,103 +1,301 @@
+#include "parser.hpp"
 #include "../object/Technology.hpp"
+#include "../util/gzip_reader.hpp"
 #include "../util/log.hpp"
+#include "../util/mapped_file.hpp"
+#include "../util/parallel.hpp"
 #include <cstring>
 #include <lefrReader.hpp>
 
 namespace sca {
 
-struct TechWrap {
-  Technology *tech;
-  Libcell *current_libcell;
+// Everything a single LEF file defines. Layers are referenced by name, so
+// that files can be parsed independently of each other and merged into the
+// Technology afterwards in file order.
+struct LefShape {
+  std::string layer;
+  BoxT<double> box;
+};
+
+struct LefPort {
+  std::string name;
+  PortDirection direction;
+  std::vector<LefShape> shapes;
+};
+
+struct LefMacro {
+  std::string name;
+  double width = 0., height = 0.;
+  std::vector<LefPort> ports;
+  std::vector<LefShape> obs;
+};
+
+struct LefLayer {
+  std::string name;
+  bool is_cut;
+  LayerDirection direction;
+  double wire_width, sq_res, sq_cap, edge_cap; // routing layer
+  double cut_res;                              // cut layer
+};
+
+// The cut layer is found among `layers` when the files are merged.
+struct LefVia {
+  std::string name;
+  std::vector<std::string> layers;
+  bool is_default;
+};
+
+struct LefStaging {
+  std::vector<LefLayer> layers;
+  std::vector<LefVia> vias;
+  std::vector<LefMacro> macros;
 };
 
 static int layerCbk(lefrCallbackType_e, lefiLayer *lef_layer, void *data) {
-  TechWrap *tw = reinterpret_cast<TechWrap *>(data);
+  LefStaging *staging = reinterpret_cast<LefStaging *>(data);
   if (std::strcmp(lef_layer->type(), "ROUTING") == 0) {
-    Layer *layer = tw->tech->makeLayer(lef_layer->name());
-    layer->setDirection(std::strcmp(lef_layer->direction(), "HORIZONTAL") == 0
-                            ? LayerDirection::Horizontal
-                            : LayerDirection::Vertical);
-    layer->setWireWidth(lef_layer->width());
-    layer->setSqRes(lef_layer->resistance());
-    layer->setSqCap(lef_layer->capacitance());
-    layer->setEdgeCap(lef_layer->edgeCap());
+    LefLayer layer;
+    layer.name = lef_layer->name();
+    layer.is_cut = false;
+    layer.direction = std::strcmp(lef_layer->direction(), "HORIZONTAL") == 0
+                          ? LayerDirection::Horizontal
+                          : LayerDirection::Vertical;
+    layer.wire_width = lef_layer->width();
+    layer.sq_res = lef_layer->resistance();
+    layer.sq_cap = lef_layer->capacitance();
+    layer.edge_cap = lef_layer->edgeCap();
+    staging->layers.push_back(std::move(layer));
   } else if (std::strcmp(lef_layer->type(), "CUT") == 0) {
-    CutLayer *cut_layer = tw->tech->makeCutLayer(lef_layer->name());
-    cut_layer->setRes(lef_layer->resistancePerCut());
+    LefLayer layer;
+    layer.name = lef_layer->name();
+    layer.is_cut = true;
+    layer.cut_res = lef_layer->resistancePerCut();
+    staging->layers.push_back(std::move(layer));
+  }
+  return 0;
+}
+
+static int viaCbk(lefrCallbackType_e, lefiVia *lef_via, void *data) {
+  LefStaging *staging = reinterpret_cast<LefStaging *>(data);
+  LefVia via;
+  via.name = lef_via->name();
+  via.is_default = lef_via->hasDefault();
+  if (lef_via->hasViaRule()) {
+    via.layers.push_back(lef_via->cutLayer());
+  } else {
+    for (int i = 0; i < lef_via->numLayers(); i++)
+      via.layers.push_back(lef_via->layerName(i));
   }
+  staging->vias.push_back(std::move(via));
   return 0;
 }
 
 static int macroBeginCbk(lefrCallbackType_e, const char *name, void *data) {
-  TechWrap *tw = reinterpret_cast<TechWrap *>(data);
-  Libcell *libcell = tw->tech->makeLibcell(name);
-  tw->current_libcell = libcell;
+  LefStaging *staging = reinterpret_cast<LefStaging *>(data);
+  staging->macros.emplace_back();
+  staging->macros.back().name = name;
   return 0;
 }
 
 static int macroCbk(lefrCallbackType_e, lefiMacro *lef_macro, void *data) {
-  TechWrap *tw = reinterpret_cast<TechWrap *>(data);
-  tw->current_libcell->setWidth(lef_macro->sizeX());
-  tw->current_libcell->setHeight(lef_macro->sizeY());
+  LefStaging *staging = reinterpret_cast<LefStaging *>(data);
+  staging->macros.back().width = lef_macro->sizeX();
+  staging->macros.back().height = lef_macro->sizeY();
   return 0;
 }
 
 static int pinCbk(lefrCallbackType_e, lefiPin *lef_pin, void *data) {
-  TechWrap *tw = reinterpret_cast<TechWrap *>(data);
-  Port *port = tw->current_libcell->makePort(lef_pin->name());
-  port->setDirection(PortDirection::Unknown);
+  LefStaging *staging = reinterpret_cast<LefStaging *>(data);
+  LefPort port;
+  port.name = lef_pin->name();
+  port.direction = PortDirection::Unknown;
   if (lef_pin->hasDirection()) {
     if (std::strcmp(lef_pin->direction(), "OUTPUT") == 0)
-      port->setDirection(PortDirection::Output);
+      port.direction = PortDirection::Output;
     else if (std::strcmp(lef_pin->direction(), "INPUT") == 0)
-      port->setDirection(PortDirection::Input);
+      port.direction = PortDirection::Input;
     else if (std::strcmp(lef_pin->direction(), "INOUT"))
-      port->setDirection(PortDirection::Inout);
+      port.direction = PortDirection::Inout;
   }
   for (int i = 0; i < lef_pin->numPorts(); i++) {
-    Layer *layer = nullptr;
+    std::string layer;
     auto geos = lef_pin->port(i);
     for (int j = 0; j < geos->numItems(); j++) {
       switch (geos->itemType(j)) {
       case lefiGeomRectE: {
         lefiGeomRect *rect = geos->getRect(j);
         BoxT<double> box(rect->xl, rect->yl, rect->xh, rect->yh);
-        port->addShape(layer, box);
+        port.shapes.push_back({layer, box});
       } break;
       case lefiGeomLayerE: {
-        const char *layer_name = geos->getLayer(j);
-        layer = tw->tech->findLayer(layer_name);
+        layer = geos->getLayer(j);
       } break;
       default:
         break;
       }
     }
   }
+  staging->macros.back().ports.push_back(std::move(port));
   return 0;
 }
 
-int readLefImpl(const std::string &lef_file_path, Technology *tech) {
-  TechWrap tw;
-  tw.tech = tech;
-  tw.current_libcell = nullptr;
+static int obstructionCbk(lefrCallbackType_e, lefiObstruction *lef_obs,
+                          void *data) {
+  LefStaging *staging = reinterpret_cast<LefStaging *>(data);
+  std::string layer;
+  lefiGeometries *geos = lef_obs->geometries();
+  for (int i = 0; i < geos->numItems(); i++) {
+    switch (geos->itemType(i)) {
+    case lefiGeomLayerE:
+      layer = geos->getLayer(i);
+      break;
+    case lefiGeomRectE: {
+      lefiGeomRect *rect = geos->getRect(i);
+      staging->macros.back().obs.push_back(
+          {layer, BoxT<double>(rect->xl, rect->yl, rect->xh, rect->yh)});
+    } break;
+    case lefiGeomPolygonE: {
+      // split into rectangles like DEF blockage polygons
+      lefiGeomPolygon *poly = geos->getPolygon(i);
+      std::vector<BoxT<double>> boxes;
+      SplitPolygon(poly->x, poly->y, poly->numPoints, boxes);
+      for (const BoxT<double> &box : boxes)
+        staging->macros.back().obs.push_back({layer, box});
+    } break;
+    default:
+      break;
+    }
+  }
+  return 0;
+}
+
+// The read function of the LEF reader has no user data, so the
+// decompressor of the calling thread is kept here.
+static thread_local GzipReader *t_lef_gzip = nullptr;
+
+static size_t readLefGzipData(FILE *, char *buffer, size_t size) {
+  return t_lef_gzip->read(buffer, size);
+}
 
+// Parse one file into `staging`. The LEF reader state is thread local, so
+// this may run on several threads at once.
+static int parseLef(const std::string &lef_file_path, LefStaging *staging) {
   lefrInit();
-  lefrSetUserData(&tw);
   lefrSetLayerCbk(layerCbk);
+  lefrSetViaCbk(viaCbk);
   lefrSetMacroBeginCbk(macroBeginCbk);
   lefrSetMacroCbk(macroCbk);
   lefrSetPinCbk(pinCbk);
+  lefrSetObstructionCbk(obstructionCbk);
 
   FILE *lef_stream = std::fopen(lef_file_path.c_str(), "r");
   if (lef_stream == nullptr) {
+    LOG_ERROR("Cound not open LEF file `%s`", lef_file_path.c_str());
+    lefrClear();
     return 1;
   }
-  int res = lefrRead(lef_stream, lef_file_path.c_str(), &tw);
+  int res;
+  if (GzipReader::isGzip(lef_file_path)) {
+    GzipReader gzip(lef_file_path);
+    t_lef_gzip = &gzip;
+    lefrSetReadFunction(readLefGzipData);
+    res = lefrRead(lef_stream, lef_file_path.c_str(), staging);
+    t_lef_gzip = nullptr;
+    if (res == 0 && gzip.failed()) {
+      LOG_ERROR("LEF file `%s` is truncated or corrupt", lef_file_path.c_str());
+      res = 1;
+    }
+  } else {
+    // Lex straight from the page cache when possible, stdio otherwise.
+    MappedFile lef_map(lef_file_path);
+    if (lef_map.isMapped())
+      lefrSetInputBuffer(lef_map.data(), lef_map.size());
+    res = lefrRead(lef_stream, lef_file_path.c_str(), staging);
+  }
   std::fclose(lef_stream);
+  lefrClear();
   if (res) {
     LOG_ERROR("Error occurred when parsing LEF file. Exit Code: %i", res);
   }
   return res;
 }
 
+static void mergeLef(const LefStaging &staging, Technology *tech) {
+  for (const auto &lef_layer : staging.layers) {
+    if (lef_layer.is_cut) {
+      CutLayer *cut_layer = tech->makeCutLayer(lef_layer.name);
+      cut_layer->setRes(lef_layer.cut_res);
+    } else {
+      Layer *layer = tech->makeLayer(lef_layer.name);
+      layer->setDirection(lef_layer.direction);
+      layer->setWireWidth(lef_layer.wire_width);
+      layer->setSqRes(lef_layer.sq_res);
+      layer->setSqCap(lef_layer.sq_cap);
+      layer->setEdgeCap(lef_layer.edge_cap);
+    }
+  }
+  std::vector<CutLayer *> via_cut_layers;
+  for (const auto &via : staging.vias) {
+    CutLayer *cut_layer = nullptr;
+    for (const auto &layer_name : via.layers) {
+      cut_layer = tech->findCutLayer(layer_name);
+      if (cut_layer) {
+        tech->makeVia(cut_layer, via.name);
+        break;
+      }
+    }
+    via_cut_layers.push_back(cut_layer);
+  }
+  // routes are written with the first DEFAULT via of a cut layer, or with
+  // its first via if none is DEFAULT
+  for (bool is_default : {true, false}) {
+    for (size_t i = 0; i < staging.vias.size(); i++) {
+      CutLayer *cut_layer = via_cut_layers[i];
+      if (cut_layer && cut_layer->viaName().empty() &&
+          staging.vias[i].is_default == is_default)
+        cut_layer->setViaName(staging.vias[i].name);
+    }
+  }
+  for (const auto &macro : staging.macros) {
+    Libcell *libcell = tech->makeLibcell(macro.name);
+    libcell->setWidth(macro.width);
+    libcell->setHeight(macro.height);
+    for (const auto &lef_port : macro.ports) {
+      Port *port = libcell->makePort(lef_port.name);
+      port->setDirection(lef_port.direction);
+      for (const auto &shape : lef_port.shapes)
+        port->addShape(tech->findLayer(shape.layer), shape.box);
+    }
+    // shapes on cut layers are skipped
+    for (const auto &shape : macro.obs) {
+      Layer *layer = tech->findLayer(shape.layer);
+      if (layer)
+        libcell->addObstruction(layer, shape.box);
+    }
+  }
+}
+
+int readLefImpl(const std::string &lef_file_path, Technology *tech) {
+  return readLefImpl(std::vector<std::string>{lef_file_path}, tech);
+}
+
+int readLefImpl(const std::vector<std::string> &lef_file_paths,
+                Technology *tech) {
+  int num_files = static_cast<int>(lef_file_paths.size());
+  std::vector<LefStaging> stagings(lef_file_paths.size());
+  std::vector<int> results(lef_file_paths.size(), 0);
+  parallelFor(0, num_files, [&](int i) {
+    results[static_cast<size_t>(i)] = parseLef(
+        lef_file_paths[static_cast<size_t>(i)], &stagings[static_cast<size_t>(i)]);
+  });
+  for (int res : results) {
+    if (res)
+      return res;
+  }
+  for (const auto &staging : stagings)
+    mergeLef(staging, tech);
+  tech->updateLayerRC();
+  return 0;
+}
+
 } // namespace sca
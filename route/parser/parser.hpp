@@ -1,15 +1,51 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace sca {
 
 class Technology;
 class Design;
+struct GuideData;
 
 int readLefImpl(const std::string &lef_file_path, Technology *tech);
-int readDefImpl(const std::string &def_file_path, Design *design);
+// Parse the files concurrently, then merge them into `tech` in order.
+int readLefImpl(const std::vector<std::string> &lef_file_paths,
+                Technology *tech);
+// With `wiring`, the regular wiring of the NETS section is added to it in dbu.
+int readDefImpl(const std::string &def_file_path, Design *design,
+                GuideData *wiring = nullptr);
+// Text guides may be gzip compressed; binary guides are detected by content.
 int readGuideImpl(const std::string &guide_file_path, Design *design);
+// Map the wiring read by readDefImpl to gcells and build the routing trees.
+int makeRoutingTreesImpl(Design *design, GuideData &wiring);
+// Write the routing trees of the nets to route as a text or binary guide.
+int writeGuideImpl(const std::string &guide_file_path, Design *design,
+                   bool binary);
+// Write the design as DEF, optionally with the routing trees as ROUTED wiring.
+int writeDefImpl(const std::string &def_file_path, Design *design,
+                 bool routes);
+// Write the RC trees of the routing trees as SPEF with the layer RC of the
+// given STA corner, gzip compressed if asked.
+int writeSpefImpl(const std::string &spef_file_path, Design *design,
+                  const std::string &corner_name, bool gzip);
+// Convert a text guide into a binary one, or a binary guide into text.
+int convertGuideImpl(const std::string &in_file_path,
+                     const std::string &out_file_path, Design *design);
+// Write `design` and its technology, optionally with the routing trees, as a
+// binary snapshot that remembers the content of the given source files.
+int writeSnapshotImpl(const std::string &snapshot_file_path,
+                      const std::vector<std::string> &lef_file_paths,
+                      const std::string &def_file_path, Design *design,
+                      bool routes);
+// Restore a snapshot into `tech` and the empty `design` and return the source
+// files it was made from. Returns 1 and leaves `tech` alone if the snapshot
+// can not be used, e.g. because a source file changed, and 2 with `tech`
+// cleared if it turns out to be corrupt while reading.
+int readSnapshotImpl(const std::string &snapshot_file_path, Technology *tech,
+                     Design *design, std::vector<std::string> &lef_file_paths,
+                     std::string &def_file_path);
 
 
 } // namespace sca
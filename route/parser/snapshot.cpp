@@ -0,0 +1,636 @@
+#include "parser.hpp"
+#include "../object/Design.hpp"
+#include "../util/log.hpp"
+#include "../util/mapped_file.hpp"
+#include "../util/output_buffer.hpp"
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+namespace sca {
+
+// A snapshot is the image of the Technology and Design built by read_lef and
+// read_def, optionally with the routing trees, so that reruns skip parsing.
+// Numbers are stored in host byte order; a foreign byte order fails the
+// version check.
+//
+//   header        see SnapshotHeader
+//   sources       path, size and content hash of the LEF files and the DEF
+//   technology    layers, cut layers, vias, libcells with ports and
+//                 obstructions
+//   design        configs, obstructions, instances with their pins and nets
+//                 with the global indices of their pins
+//   routes        optional: pin positions and routing trees in preorder
+//
+// The grid is not stored: rebuilding it from the configs is faster than
+// loading its capacities. A snapshot is refused as soon as one of its source
+// files no longer matches its hash.
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  uint64_t file_size;
+};
+
+static constexpr char kSnapshotMagic[8] = {'S', 'C', 'A', 'S',
+                                           'N', 'A', 'P', '\0'};
+static constexpr uint32_t kSnapshotVersion = 3;
+static constexpr uint32_t kSnapshotRoutes = 1;
+
+class SnapshotWriter {
+public:
+  SnapshotWriter() { m_out.reserve(size_t(1) << 20); }
+
+  template <class T> void put(const T &value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    m_out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+  void putString(std::string_view str) {
+    put(static_cast<uint32_t>(str.size()));
+    m_out.append(str.data(), str.size());
+  }
+  std::string &buffer() { return m_out; }
+
+private:
+  std::string m_out;
+};
+
+// Reads what SnapshotWriter wrote. Reading past the end or a failed check
+// puts the reader into a failed state, in which it only returns zeros.
+class SnapshotReader {
+public:
+  SnapshotReader(const char *begin, const char *end)
+      : m_p(begin), m_end(end) {}
+
+  bool ok() const { return m_ok; }
+  bool atEnd() const { return m_ok && m_p == m_end; }
+  void fail() { m_ok = false; }
+
+  template <class T> T get() {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T value{};
+    if (const char *p = take(sizeof(T)))
+      std::memcpy(&value, p, sizeof(T));
+    return value;
+  }
+  std::string_view getString() {
+    uint32_t size = get<uint32_t>();
+    const char *p = take(size);
+    return p ? std::string_view(p, size) : std::string_view();
+  }
+  // Number of objects that follow, each at least `min_size` bytes long. A
+  // count that can not fit into the rest of the file fails the reader.
+  size_t getCount(size_t min_size) {
+    uint64_t count = get<uint64_t>();
+    if (count > static_cast<uint64_t>(m_end - m_p) / min_size) {
+      m_ok = false;
+      return 0;
+    }
+    return static_cast<size_t>(count);
+  }
+  // An index that must be less than `size`.
+  size_t getIndex(size_t size) {
+    uint32_t idx = get<uint32_t>();
+    if (idx >= size) {
+      m_ok = false;
+      return 0;
+    }
+    return idx;
+  }
+
+private:
+  const char *take(size_t size) {
+    if (!m_ok || size > static_cast<size_t>(m_end - m_p)) {
+      m_ok = false;
+      return nullptr;
+    }
+    const char *p = m_p;
+    m_p += size;
+    return p;
+  }
+
+  const char *m_p, *m_end;
+  bool m_ok = true;
+};
+
+// 64 bit hash of a byte range, one multiply per word.
+static uint64_t hashBytes(const char *data, size_t size) {
+  constexpr uint64_t kMul = 0x9e3779b97f4a7c15ULL;
+  auto mix = [](uint64_t h, uint64_t w) {
+    w *= 0xff51afd7ed558ccdULL;
+    w ^= w >> 32;
+    h = (h ^ w) * kMul;
+    return (h << 31) | (h >> 33);
+  };
+  uint64_t h = size * kMul;
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t w;
+    std::memcpy(&w, data + i, sizeof(w));
+    h = mix(h, w);
+  }
+  if (i < size) {
+    uint64_t w = 0;
+    std::memcpy(&w, data + i, size - i);
+    h = mix(h, w);
+  }
+  return h ^ (h >> 29);
+}
+
+struct SourceFile {
+  uint64_t size, hash;
+};
+
+static bool hashSourceFile(const std::string &path, SourceFile &source) {
+  MappedFile file(path);
+  if (!file.isMapped())
+    return false;
+  source.size = file.size();
+  source.hash = hashBytes(file.data(), file.size());
+  return true;
+}
+
+//
+// writer
+//
+
+static void putLayerIdx(SnapshotWriter &w, const Layer *layer) {
+  w.put(static_cast<int32_t>(layer ? layer->idx() : -1));
+}
+
+template <class T>
+static void putBox(SnapshotWriter &w, const BoxT<T> &box) {
+  w.put(box.lx());
+  w.put(box.ly());
+  w.put(box.hx());
+  w.put(box.hy());
+}
+
+// `shape(i)` returns the i-th of `num_shapes` shapes
+template <class Shape>
+static void putShapes(SnapshotWriter &w, int num_shapes, Shape shape) {
+  w.put(static_cast<uint32_t>(num_shapes));
+  for (size_t i = 0; i < static_cast<size_t>(num_shapes); i++) {
+    const auto &[layer, box] = shape(i);
+    putLayerIdx(w, layer);
+    putBox(w, box);
+  }
+}
+
+static void
+putTechnology(SnapshotWriter &w, Technology *tech,
+              std::unordered_map<const Libcell *, uint32_t> &libcell_ids) {
+  w.put(static_cast<uint64_t>(tech->numLayers()));
+  for (int i = 0; i < tech->numLayers(); i++) {
+    const Layer *layer = tech->layer(i);
+    w.putString(layer->name());
+    w.put(static_cast<int32_t>(layer->direction()));
+    w.put(layer->wireWidth());
+    w.put(layer->sqRes());
+    w.put(layer->sqCap());
+    w.put(layer->edgeCap());
+  }
+  w.put(static_cast<uint64_t>(tech->numCutLayers()));
+  for (int i = 0; i < tech->numCutLayers(); i++) {
+    const CutLayer *cut_layer = tech->cutLayer(i);
+    w.putString(cut_layer->name());
+    w.put(cut_layer->res());
+    w.putString(cut_layer->viaName());
+  }
+  // sorted so that the same technology gives the same file
+  std::vector<std::pair<std::string, int>> vias(tech->viaCutLayers().begin(),
+                                                tech->viaCutLayers().end());
+  std::sort(vias.begin(), vias.end());
+  w.put(static_cast<uint64_t>(vias.size()));
+  for (const auto &[via_name, cut_layer_idx] : vias) {
+    w.putString(via_name);
+    w.put(static_cast<uint32_t>(cut_layer_idx));
+  }
+  w.put(static_cast<uint64_t>(tech->numLibcells()));
+  for (int i = 0; i < tech->numLibcells(); i++) {
+    Libcell *libcell = tech->libcell(i);
+    libcell_ids.emplace(libcell, static_cast<uint32_t>(i));
+    w.putString(libcell->name());
+    w.put(libcell->width());
+    w.put(libcell->height());
+    w.put(static_cast<uint64_t>(libcell->numPorts()));
+    for (size_t j = 0; j < static_cast<size_t>(libcell->numPorts()); j++) {
+      const Port *port = libcell->port(j);
+      w.putString(port->name());
+      w.put(static_cast<int32_t>(port->direction()));
+      putShapes(w, port->numShapes(),
+                [&](size_t k) -> const auto & { return port->shape(k); });
+    }
+    putShapes(w, libcell->numObstructions(), [&](size_t k) -> const auto & {
+      return libcell->obstruction(k);
+    });
+  }
+}
+
+static void putInstance(SnapshotWriter &w, const Instance *inst,
+                        const std::unordered_map<const Libcell *, uint32_t>
+                            &libcell_ids,
+                        std::unordered_map<const Pin *, uint32_t> &pin_ids) {
+  auto libcell_id = libcell_ids.find(inst->libcell());
+  ASSERT(libcell_id != libcell_ids.end(), "Instance `%s` has no libcell",
+         inst->name().c_str());
+  w.putString(inst->name());
+  w.put(libcell_id->second);
+  w.putString(inst->staName());
+  w.put(inst->lx());
+  w.put(inst->ly());
+  w.put(static_cast<int32_t>(inst->orientation()));
+  w.put(static_cast<uint64_t>(inst->numPins()));
+  for (int i = 0; i < inst->numPins(); i++) {
+    const Pin *pin = inst->pin(i);
+    pin_ids.emplace(pin, static_cast<uint32_t>(pin_ids.size()));
+    w.putString(pin->name());
+  }
+}
+
+static void putDesign(SnapshotWriter &w, Design *design,
+                      const std::unordered_map<const Libcell *, uint32_t>
+                          &libcell_ids) {
+  w.put(static_cast<double>(design->dbu()));
+  putBox(w, design->dieBox());
+  w.put(static_cast<uint64_t>(design->trackConfigs().size()));
+  for (const TrackConfig &tc : design->trackConfigs()) {
+    putLayerIdx(w, tc.layer);
+    w.put(tc.start);
+    w.put(tc.step);
+    w.put(tc.count);
+  }
+  w.put(static_cast<uint64_t>(design->gridConfigs().size()));
+  for (const GridConfig &gc : design->gridConfigs()) {
+    w.put(static_cast<int32_t>(gc.direction));
+    w.put(gc.start);
+    w.put(gc.step);
+    w.put(gc.count);
+  }
+  const GcellSizeConfig &gcell_size = design->gcellSizeConfig();
+  w.put(static_cast<int32_t>(gcell_size.mode));
+  w.put(gcell_size.pitch);
+  w.put(gcell_size.count);
+  w.put(gcell_size.memory_mb);
+  w.put(static_cast<uint64_t>(design->obstructions().size()));
+  for (const auto &[layer, box] : design->obstructions()) {
+    putLayerIdx(w, layer);
+    putBox(w, box);
+  }
+
+  // pins are numbered in the order they are written
+  std::unordered_map<const Pin *, uint32_t> pin_ids;
+  putInstance(w, design->topInstance(), libcell_ids, pin_ids);
+  w.put(static_cast<uint64_t>(design->numInstances()));
+  for (int i = 0; i < design->numInstances(); i++)
+    putInstance(w, design->instance(i), libcell_ids, pin_ids);
+  w.put(static_cast<uint64_t>(design->numNets()));
+  for (int i = 0; i < design->numNets(); i++) {
+    const Net *net = design->net(i);
+    w.putString(net->name());
+    w.putString(net->staName());
+    w.put(static_cast<uint64_t>(net->numPins()));
+    for (int j = 0; j < net->numPins(); j++)
+      w.put(pin_ids.at(net->pin(j)));
+  }
+}
+
+static void putRoutes(SnapshotWriter &w, Design *design) {
+  uint64_t num_trees = 0;
+  for (int i = 0; i < design->numNets(); i++)
+    num_trees += design->net(i)->routingTree() != nullptr;
+  w.put(num_trees);
+  for (int i = 0; i < design->numNets(); i++) {
+    const Net *net = design->net(i);
+    if (net->routingTree() == nullptr)
+      continue;
+    w.put(static_cast<uint32_t>(i));
+    for (int j = 0; j < net->numPins(); j++) {
+      const PointOnLayerT<int> &pos = net->pin(j)->position();
+      w.put(pos.layerIdx);
+      w.put(pos.x);
+      w.put(pos.y);
+    }
+    uint64_t num_nodes = 0;
+    GRTreeNode::preorder(net->routingTree(),
+                         [&](std::shared_ptr<GRTreeNode>) { num_nodes++; });
+    w.put(num_nodes);
+    GRTreeNode::preorder(net->routingTree(),
+                         [&](std::shared_ptr<GRTreeNode> node) {
+                           w.put(node->layerIdx);
+                           w.put(node->x);
+                           w.put(node->y);
+                           w.put(static_cast<uint32_t>(node->children.size()));
+                         });
+  }
+}
+
+int writeSnapshotImpl(const std::string &snapshot_file_path,
+                      const std::vector<std::string> &lef_file_paths,
+                      const std::string &def_file_path, Design *design,
+                      bool routes) {
+  if (design == nullptr || design->grid() == nullptr) {
+    LOG_ERROR("no design to write a snapshot of");
+    return 1;
+  }
+  SnapshotWriter w;
+  SnapshotHeader header;
+  std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+  header.version = kSnapshotVersion;
+  header.flags = routes ? kSnapshotRoutes : 0;
+  header.file_size = 0; // patched below
+  w.put(header);
+
+  auto put_source = [&](const std::string &path) {
+    SourceFile source;
+    if (!hashSourceFile(path, source)) {
+      LOG_ERROR("can not read source file %s", path.c_str());
+      return false;
+    }
+    w.putString(path);
+    w.put(source);
+    return true;
+  };
+  w.put(static_cast<uint64_t>(lef_file_paths.size()));
+  for (const std::string &path : lef_file_paths) {
+    if (!put_source(path))
+      return 1;
+  }
+  if (!put_source(def_file_path))
+    return 1;
+
+  Technology *tech = design->technology();
+  std::unordered_map<const Libcell *, uint32_t> libcell_ids;
+  putTechnology(w, tech, libcell_ids);
+  putDesign(w, design, libcell_ids);
+  if (routes)
+    putRoutes(w, design);
+
+  std::string &out = w.buffer();
+  header.file_size = out.size();
+  std::memcpy(out.data(), &header, sizeof(header));
+  if (!writeBuffers(snapshot_file_path, {std::string_view(out)})) {
+    LOG_ERROR("can not write file %s", snapshot_file_path.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+//
+// reader
+//
+
+static Layer *getLayer(SnapshotReader &r, Technology *tech) {
+  int32_t idx = r.get<int32_t>();
+  if (idx < -1 || idx >= tech->numLayers()) {
+    r.fail();
+    return nullptr;
+  }
+  return idx < 0 ? nullptr : tech->layer(idx);
+}
+
+template <class T> static BoxT<T> getBox(SnapshotReader &r) {
+  T lx = r.get<T>(), ly = r.get<T>();
+  T hx = r.get<T>(), hy = r.get<T>();
+  return BoxT<T>(lx, ly, hx, hy);
+}
+
+template <class Add>
+static void getShapes(SnapshotReader &r, Technology *tech, Add add) {
+  uint32_t num_shapes = r.get<uint32_t>();
+  for (uint32_t i = 0; i < num_shapes && r.ok(); i++) {
+    Layer *layer = getLayer(r, tech);
+    add(layer, getBox<double>(r));
+  }
+}
+
+template <class Enum> static Enum getEnum(SnapshotReader &r, int num_values) {
+  int32_t value = r.get<int32_t>();
+  if (value < 0 || value >= num_values)
+    r.fail();
+  return static_cast<Enum>(value);
+}
+
+static void getTechnology(SnapshotReader &r, Technology *tech) {
+  size_t num_layers = r.getCount(40);
+  for (size_t i = 0; i < num_layers && r.ok(); i++) {
+    Layer *layer = tech->makeLayer(std::string(r.getString()));
+    layer->setDirection(getEnum<LayerDirection>(r, 2));
+    layer->setWireWidth(r.get<double>());
+    layer->setSqRes(r.get<double>());
+    layer->setSqCap(r.get<double>());
+    layer->setEdgeCap(r.get<double>());
+  }
+  size_t num_cut_layers = r.getCount(16);
+  for (size_t i = 0; i < num_cut_layers && r.ok(); i++) {
+    CutLayer *cut_layer = tech->makeCutLayer(std::string(r.getString()));
+    cut_layer->setRes(r.get<double>());
+    cut_layer->setViaName(std::string(r.getString()));
+  }
+  size_t num_vias = r.getCount(8);
+  for (size_t i = 0; i < num_vias && r.ok(); i++) {
+    std::string via_name(r.getString());
+    size_t cut_layer_idx = r.getIndex(static_cast<size_t>(tech->numCutLayers()));
+    if (r.ok())
+      tech->makeVia(tech->cutLayer(static_cast<int>(cut_layer_idx)), via_name);
+  }
+  size_t num_libcells = r.getCount(32);
+  for (size_t i = 0; i < num_libcells && r.ok(); i++) {
+    Libcell *libcell = tech->makeLibcell(std::string(r.getString()));
+    libcell->setWidth(r.get<double>());
+    libcell->setHeight(r.get<double>());
+    size_t num_ports = r.getCount(12);
+    for (size_t j = 0; j < num_ports && r.ok(); j++) {
+      Port *port = libcell->makePort(std::string(r.getString()));
+      port->setDirection(getEnum<PortDirection>(r, 4));
+      getShapes(r, tech, [&](Layer *layer, const BoxT<double> &box) {
+        port->addShape(layer, box);
+      });
+    }
+    getShapes(r, tech, [&](Layer *layer, const BoxT<double> &box) {
+      libcell->addObstruction(layer, box);
+    });
+  }
+}
+
+static void getInstancePins(SnapshotReader &r, Instance *inst,
+                            std::vector<Pin *> &pins) {
+  size_t num_pins = r.getCount(4);
+  for (size_t i = 0; i < num_pins && r.ok(); i++)
+    pins.push_back(inst->makePin(std::string(r.getString())));
+}
+
+static void getDesign(SnapshotReader &r, Technology *tech, Design *design) {
+  design->setDbu(r.get<double>());
+  design->setDieBox(getBox<DBU>(r));
+  size_t num_tcs = r.getCount(16);
+  for (size_t i = 0; i < num_tcs && r.ok(); i++) {
+    Layer *layer = getLayer(r, tech);
+    DBU start = r.get<DBU>(), step = r.get<DBU>();
+    int count = r.get<int>();
+    if (layer == nullptr)
+      r.fail();
+    design->addTrackConfig({layer, start, step, count});
+  }
+  size_t num_gcs = r.getCount(16);
+  for (size_t i = 0; i < num_gcs && r.ok(); i++) {
+    LayerDirection direction = getEnum<LayerDirection>(r, 2);
+    DBU start = r.get<DBU>(), step = r.get<DBU>();
+    int count = r.get<int>();
+    design->addGridConfig({direction, start, step, count});
+  }
+  GcellSizeConfig gcell_size;
+  gcell_size.mode = getEnum<GcellSizeMode>(r, 4);
+  gcell_size.pitch = r.get<DBU>();
+  gcell_size.count = r.get<long long>();
+  gcell_size.memory_mb = r.get<double>();
+  design->setGcellSizeConfig(gcell_size);
+  size_t num_obs = r.getCount(20);
+  for (size_t i = 0; i < num_obs && r.ok(); i++) {
+    Layer *layer = getLayer(r, tech);
+    design->addObstruction(layer, getBox<DBU>(r));
+  }
+
+  std::vector<Pin *> pins;
+  auto get_instance = [&](bool top) {
+    std::string name(r.getString());
+    Libcell *libcell =
+        tech->libcell(static_cast<int>(r.getIndex(tech->numLibcells())));
+    if (!r.ok())
+      return;
+    Instance *inst = top ? design->makeTopInstance(name, libcell)
+                         : design->makeInstance(name, libcell);
+    inst->setStaName(std::string(r.getString()));
+    inst->setLx(r.get<DBU>());
+    inst->setLy(r.get<DBU>());
+    inst->setOrientation(getEnum<Orientation>(r, 8));
+    getInstancePins(r, inst, pins);
+  };
+  if (tech->numLibcells() == 0) {
+    r.fail();
+    return;
+  }
+  get_instance(true);
+  size_t num_instances = r.getCount(28);
+  design->reserve(num_instances, 0);
+  for (size_t i = 0; i < num_instances && r.ok(); i++)
+    get_instance(false);
+  size_t num_nets = r.getCount(16);
+  design->reserve(num_instances, num_nets);
+  for (size_t i = 0; i < num_nets && r.ok(); i++) {
+    Net *net = design->makeNet(std::string(r.getString()));
+    net->setStaName(std::string(r.getString()));
+    size_t num_pins = r.getCount(4);
+    for (size_t j = 0; j < num_pins && r.ok(); j++) {
+      Pin *pin = pins[r.getIndex(pins.size())];
+      if (r.ok())
+        net->connect(pin);
+    }
+  }
+}
+
+static void getRoutes(SnapshotReader &r, Design *design) {
+  size_t num_trees = r.getCount(20);
+  for (size_t i = 0; i < num_trees && r.ok(); i++) {
+    Net *net = design->net(
+        static_cast<int>(r.getIndex(static_cast<size_t>(design->numNets()))));
+    if (!r.ok())
+      return;
+    for (int j = 0; j < net->numPins(); j++) {
+      int l = r.get<int>(), x = r.get<int>(), y = r.get<int>();
+      net->pin(j)->setPosition(PointOnLayerT<int>(l, x, y));
+    }
+    // rebuild the tree from the preorder with the number of children left
+    // to read for each open node
+    size_t num_nodes = r.getCount(16);
+    std::shared_ptr<GRTreeNode> root;
+    std::vector<std::pair<GRTreeNode *, uint32_t>> open;
+    for (size_t k = 0; k < num_nodes && r.ok(); k++) {
+      int l = r.get<int>(), x = r.get<int>(), y = r.get<int>();
+      uint32_t num_children = r.get<uint32_t>();
+      auto node = std::make_shared<GRTreeNode>(l, x, y);
+      if (root == nullptr) {
+        root = node;
+      } else if (open.empty()) {
+        r.fail();
+        break;
+      } else {
+        open.back().first->children.push_back(node);
+        if (--open.back().second == 0)
+          open.pop_back();
+      }
+      if (num_children > 0)
+        open.emplace_back(node.get(), num_children);
+    }
+    if (root == nullptr || !open.empty())
+      r.fail();
+    net->setRoutingTree(root);
+  }
+}
+
+int readSnapshotImpl(const std::string &snapshot_file_path, Technology *tech,
+                     Design *design, std::vector<std::string> &lef_file_paths,
+                     std::string &def_file_path) {
+  MappedFile file(snapshot_file_path);
+  if (!file.isMapped()) {
+    LOG_ERROR("can not open file %s", snapshot_file_path.c_str());
+    return 1;
+  }
+  SnapshotReader r(file.data(), file.data() + file.size());
+  SnapshotHeader header = r.get<SnapshotHeader>();
+  if (!r.ok() ||
+      std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) !=
+          0 ||
+      header.version != kSnapshotVersion || header.file_size != file.size()) {
+    LOG_ERROR("%s is not a valid snapshot", snapshot_file_path.c_str());
+    return 1;
+  }
+
+  // check the sources before anything is touched
+  std::vector<std::string> paths;
+  size_t num_lef_files = r.getCount(20);
+  for (size_t i = 0; i <= num_lef_files && r.ok(); i++) {
+    std::string path(r.getString());
+    SourceFile stored = r.get<SourceFile>(), current;
+    if (!r.ok())
+      break;
+    if (!hashSourceFile(path, current) || current.size != stored.size ||
+        current.hash != stored.hash) {
+      LOG_WARN("snapshot %s is out of date, %s changed",
+               snapshot_file_path.c_str(), path.c_str());
+      return 1;
+    }
+    paths.push_back(std::move(path));
+  }
+  if (!r.ok()) {
+    LOG_ERROR("%s is not a valid snapshot", snapshot_file_path.c_str());
+    return 1;
+  }
+
+  tech->reset();
+  getTechnology(r, tech);
+  tech->updateLayerRC();
+  if (r.ok())
+    getDesign(r, tech, design);
+  if (r.ok())
+    design->makeGrid();
+  if (r.ok() && (header.flags & kSnapshotRoutes))
+    getRoutes(r, design);
+  if (!r.atEnd()) {
+    LOG_ERROR("snapshot %s is corrupt", snapshot_file_path.c_str());
+    tech->reset();
+    return 2;
+  }
+  def_file_path = std::move(paths.back());
+  paths.pop_back();
+  lef_file_paths = std::move(paths);
+  LOG_INFO("read snapshot %s: %d instances, %d nets",
+           snapshot_file_path.c_str(), design->numInstances(),
+           design->numNets());
+  return 0;
+}
+
+} // namespace sca
@@ -0,0 +1,270 @@
+#include "parser.hpp"
+#include "../object/Design.hpp"
+#include "../timing/RcTree.hpp"
+#include "../util/log.hpp"
+#include "../util/output_buffer.hpp"
+#include "../util/parallel.hpp"
+#include <algorithm>
+#include <ctime>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace sca {
+
+// The nets are written in batches: worker threads build the RC tree of each
+// net and format it, compressed if asked, into one buffer per part of the
+// batch, and a batch is written while the next one is formatted. Nets are
+// `*<index + 1>` and instances `*<number of nets + index + 1>` in the name
+// map, ports keep their names.
+
+// Number of nets per batch.
+static constexpr int kSpefBatchSize = 16384;
+
+struct SpefFormat {
+  Design *design;
+  int rc_corner;
+  bool gzip;
+  std::unordered_map<const Instance *, int> instance_ids;
+};
+
+static char spefDirection(const Pin *pin) {
+  Libcell *libcell = pin->instance()->libcell();
+  Port *port = libcell ? libcell->findPort(pin->name()) : nullptr;
+  switch (port ? port->direction() : PortDirection::Inout) {
+  case PortDirection::Input:
+    return 'I';
+  case PortDirection::Output:
+    return 'O';
+  default:
+    return 'B';
+  }
+}
+
+static void appendName(std::string &out, int name_idx) {
+  out += '*';
+  appendInt(out, name_idx + 1);
+}
+
+// `*<instance>:<pin>` for instance pins, the port name for top level pins.
+static void appendPinNode(std::string &out, const SpefFormat &format,
+                          const Pin *pin) {
+  const Instance *inst = pin->instance();
+  if (inst == format.design->topInstance()) {
+    appendWord(out, pin->name());
+    return;
+  }
+  appendName(out, format.design->numNets() + format.instance_ids.at(inst));
+  out += ':';
+  appendWord(out, pin->name());
+}
+
+static void appendNet(std::string &out, const SpefFormat &format, int net_idx,
+                      const RcTree &tree) {
+  Design *design = format.design;
+  const Net *net = design->net(net_idx);
+  auto append_node = [&](int node) {
+    appendName(out, net_idx);
+    out += ':';
+    appendInt(out, node + 1);
+  };
+  // farads and ohms to the units of the header
+  auto append_cap = [&](double cap) {
+    appendFloat(out, static_cast<float>(cap * 1e12), 6);
+  };
+  double total_cap = 0.0;
+  for (int i = 0; i < tree.numNodes(); i++)
+    total_cap += tree.cap(i, 0);
+
+  out += "\n*D_NET ";
+  appendName(out, net_idx);
+  out += ' ';
+  append_cap(total_cap);
+  out += "\n*CONN\n";
+  for (int i = 0; i < net->numPins(); i++) {
+    const Pin *pin = net->pin(i);
+    out += pin->instance() == design->topInstance() ? "*P " : "*I ";
+    appendPinNode(out, format, pin);
+    out += ' ';
+    out += spefDirection(pin);
+    out += '\n';
+  }
+  out += "*CAP\n";
+  int id = 1;
+  for (int i = 0; i < tree.numNodes(); i++) {
+    float cap = tree.cap(i, 0);
+    if (cap == 0.f)
+      continue;
+    appendInt(out, id++);
+    out += ' ';
+    append_node(i);
+    out += ' ';
+    append_cap(cap);
+    out += '\n';
+  }
+  // pins connect to their route node with 0 ohm like for OpenSTA
+  out += "*RES\n";
+  id = 1;
+  for (size_t r = 0; r < tree.resistors.size(); r++) {
+    appendInt(out, id++);
+    out += ' ';
+    append_node(tree.resistors[r].node1);
+    out += ' ';
+    append_node(tree.resistors[r].node2);
+    out += ' ';
+    appendFloat(out, tree.resistance(static_cast<int>(r), 0), 6);
+    out += '\n';
+  }
+  for (int i = 0; i < net->numPins(); i++) {
+    appendInt(out, id++);
+    out += ' ';
+    appendPinNode(out, format, net->pin(i));
+    out += ' ';
+    append_node(tree.pin_nodes[static_cast<size_t>(i)]);
+    out += " 0\n";
+  }
+  out += "*END\n";
+}
+
+static void appendNets(std::string &out, const SpefFormat &format, int begin,
+                       int end) {
+  RcTreeBuilder builder(format.design, {format.rc_corner});
+  RcTree tree;
+  std::string text;
+  std::string &net_out = format.gzip ? text : out;
+  for (int i = begin; i < end; i++) {
+    const Net *net = format.design->net(i);
+    if (net->numPins() == 0)
+      continue;
+    builder.build(net, tree);
+    appendNet(net_out, format, i, tree);
+  }
+  if (format.gzip)
+    appendGzip(out, text);
+}
+
+static std::string spefHeader(Design *design) {
+  char date[64];
+  std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%a %b %d %H:%M:%S %Y",
+                std::localtime(&now));
+  std::string out = "*SPEF \"IEEE 1481-1998\"\n*DESIGN \"";
+  appendWord(out, design->name());
+  out += "\"\n*DATE \"";
+  out += date;
+  out += "\"\n"
+         "*VENDOR \"route_sta\"\n"
+         "*PROGRAM \"route_sta\"\n"
+         "*VERSION \"1.0\"\n"
+         "*DESIGN_FLOW \"PIN_CAP NONE\"\n"
+         "*DIVIDER /\n"
+         "*DELIMITER :\n"
+         "*BUS_DELIMITER [ ]\n"
+         "*T_UNIT 1 NS\n"
+         "*C_UNIT 1 PF\n"
+         "*R_UNIT 1 OHM\n"
+         "*L_UNIT 1 HENRY\n";
+  return out;
+}
+
+// Name map entries [begin, end), nets first and then instances.
+static void appendNameMap(std::string &out, Design *design, int begin,
+                          int end) {
+  int num_nets = design->numNets();
+  for (int i = begin; i < end; i++) {
+    appendName(out, i);
+    out += ' ';
+    appendWord(out, i < num_nets ? design->net(i)->name()
+                                 : design->instance(i - num_nets)->name());
+    out += '\n';
+  }
+}
+
+static std::string spefPorts(Design *design) {
+  Instance *top = design->topInstance();
+  std::string out = "\n*PORTS\n";
+  for (int i = 0; i < top->numPins(); i++) {
+    const Pin *pin = top->pin(i);
+    appendWord(out, pin->name());
+    out += ' ';
+    out += spefDirection(pin);
+    out += '\n';
+  }
+  return out;
+}
+
+// Split [0, size) into parts for all threads and format them into `buffers`.
+template <typename Append>
+static void formatParts(int size, std::vector<std::string> &buffers,
+                        const Append &append) {
+  int num_parts = std::max(1, std::min(4 * numThreads(), size));
+  buffers.assign(static_cast<size_t>(num_parts), std::string());
+  parallelFor(0, num_parts, [&](int t) {
+    int begin = static_cast<int>(static_cast<long long>(size) * t / num_parts);
+    int end =
+        static_cast<int>(static_cast<long long>(size) * (t + 1) / num_parts);
+    append(buffers[static_cast<size_t>(t)], begin, end);
+  });
+}
+
+int writeSpefImpl(const std::string &spef_file_path, Design *design,
+                  const std::string &corner_name, bool gzip) {
+  const Technology *tech = design->technology();
+  int rc_corner = tech->findRcCorner(corner_name);
+  if (rc_corner == 0 && !corner_name.empty())
+    LOG_WARN("no layer RC set for corner %s, the default one is used",
+             corner_name.c_str());
+  SpefFormat format{design, rc_corner, gzip, {}};
+  for (int i = 0; i < design->numInstances(); i++)
+    format.instance_ids.emplace(design->instance(i), i);
+  OutputFile file(spef_file_path);
+  if (!file.isOpen()) {
+    LOG_ERROR("can not write file %s", spef_file_path.c_str());
+    return 1;
+  }
+
+  // header, name map and ports
+  std::vector<std::string> head;
+  int num_names = design->numNets() + design->numInstances();
+  formatParts(num_names, head, [&](std::string &out, int begin, int end) {
+    appendNameMap(out, design, begin, end);
+  });
+  head.insert(head.begin(), spefHeader(design) + "\n*NAME_MAP\n");
+  head.push_back(spefPorts(design));
+  if (gzip) {
+    parallelFor(0, static_cast<int>(head.size()), [&](int t) {
+      std::string text;
+      text.swap(head[static_cast<size_t>(t)]);
+      appendGzip(head[static_cast<size_t>(t)], text);
+    });
+  }
+  file.write(head);
+
+  // nets
+  int num_nets = design->numNets();
+  std::vector<std::string> batches[2];
+  std::thread writer;
+  for (int begin = 0, b = 0; begin < num_nets;
+       begin += kSpefBatchSize, b ^= 1) {
+    int size = std::min(kSpefBatchSize, num_nets - begin);
+    formatParts(size, batches[b], [&](std::string &out, int first, int last) {
+      appendNets(out, format, begin + first, begin + last);
+    });
+    // write this batch while the next one is formatted
+    if (writer.joinable())
+      writer.join();
+    if (numThreads() > 1)
+      writer = std::thread([&file, &batches, b]() { file.write(batches[b]); });
+    else
+      file.write(batches[b]);
+  }
+  if (writer.joinable())
+    writer.join();
+  if (!file.close()) {
+    LOG_ERROR("can not write file %s", spef_file_path.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace sca
@@ -1,5 +1,7 @@
 #include "RouteTcl.hpp"
 #include "../context/Context.hpp"
+#include "../util/parallel.hpp"
+#include <cstring>
 #include <math.h>
 #include <sta/Sta.hh>
 #include <tcl.h>
@@ -8,22 +10,36 @@ namespace sca {
 
 static int read_lef_cmd(ClientData, Tcl_Interp *interp, int objc,
                         Tcl_Obj *CONST objv[]) {
-  if (objc != 2) {
-    Tcl_WrongNumArgs(interp, objc, objv, "Usage : sca::read_lef lef_file");
+  if (objc < 2) {
+    Tcl_WrongNumArgs(interp, objc, objv,
+                     "Usage : sca::read_lef lef_file [lef_file ...]");
     return TCL_ERROR;
   }
-  const char *lef_file = Tcl_GetStringFromObj(objv[1], nullptr);
-  return sca::Context::ctx()->readLef(lef_file);
+  // every argument may itself be a list of files
+  std::vector<std::string> lef_files;
+  for (int i = 1; i < objc; i++) {
+    int num_elems;
+    Tcl_Obj **elems;
+    if (Tcl_ListObjGetElements(interp, objv[i], &num_elems, &elems) != TCL_OK)
+      return TCL_ERROR;
+    for (int j = 0; j < num_elems; j++)
+      lef_files.emplace_back(Tcl_GetString(elems[j]));
+  }
+  return sca::Context::ctx()->readLef(lef_files);
 }
 
 static int read_def_cmd(ClientData, Tcl_Interp *interp, int objc,
                         Tcl_Obj *CONST objv[]) {
-  if (objc != 2) {
-    Tcl_WrongNumArgs(interp, objc, objv, "Usage : sca::read_def def_file");
+  bool use_routing =
+      objc == 3 && (std::strcmp(Tcl_GetString(objv[2]), "use_routing") == 0 ||
+                    std::strcmp(Tcl_GetString(objv[2]), "-use_routing") == 0);
+  if (objc != 2 && !use_routing) {
+    Tcl_WrongNumArgs(interp, objc, objv,
+                     "Usage : sca::read_def def_file [use_routing]");
     return TCL_ERROR;
   }
   const char *def_file = Tcl_GetStringFromObj(objv[1], nullptr);
-  return sca::Context::ctx()->readDef(def_file);
+  return sca::Context::ctx()->readDef(def_file, use_routing);
 }
 
 static int link_design_cmd(ClientData, Tcl_Interp *interp, int objc,
@@ -48,11 +64,31 @@ static int run_cugr2_cmd(ClientData, Tcl_Interp *interp, int objc,
 
 static int estimate_parasitics_cmd(ClientData, Tcl_Interp *interp, int objc,
                                    Tcl_Obj *CONST objv[]) {
-  if (objc != 1) {
-    Tcl_WrongNumArgs(interp, objc, objv, "Usage : sca::estimate_parasitics");
-    return TCL_ERROR;
+  const char *usage =
+      "Usage : sca::estimate_parasitics [-all] [-reduce sta|direct]";
+  bool all = false;
+  ReduceMode mode = ReduceMode::Sta;
+  for (int i = 1; i < objc; i++) {
+    const char *opt = Tcl_GetString(objv[i]);
+    if (std::strcmp(opt, "-all") == 0) {
+      all = true;
+    } else if (std::strcmp(opt, "-reduce") == 0 && i + 1 < objc) {
+      const char *value = Tcl_GetString(objv[++i]);
+      if (std::strcmp(value, "sta") == 0) {
+        mode = ReduceMode::Sta;
+      } else if (std::strcmp(value, "direct") == 0) {
+        mode = ReduceMode::Direct;
+      } else {
+        Tcl_WrongNumArgs(interp, objc, objv, usage);
+        return TCL_ERROR;
+      }
+    } else {
+      Tcl_WrongNumArgs(interp, objc, objv, usage);
+      return TCL_ERROR;
+    }
   }
-  return sca::Context::ctx()->estimateParasitcs() ? TCL_OK : TCL_ERROR;
+  return sca::Context::ctx()->estimateParasitcs(all, mode) ? TCL_ERROR
+                                                           : TCL_OK;
 }
 
 static int read_guide_cmd(ClientData, Tcl_Interp *interp, int objc,
@@ -67,11 +103,89 @@ static int read_guide_cmd(ClientData, Tcl_Interp *interp, int objc,
 
 static int write_guide_cmd(ClientData, Tcl_Interp *interp, int objc,
                            Tcl_Obj *CONST objv[]) {
+  bool binary = objc == 3 && std::strcmp(Tcl_GetString(objv[1]), "-binary") == 0;
+  if (objc != 2 && !binary) {
+    Tcl_WrongNumArgs(interp, objc, objv,
+                     "Usage : sca::write_guide [-binary] guide_file");
+    return TCL_ERROR;
+  }
+  const char *guide_file = Tcl_GetStringFromObj(objv[objc - 1], nullptr);
+  return sca::Context::ctx()->writeGuide(guide_file, binary) ? TCL_ERROR
+                                                             : TCL_OK;
+}
+
+static int convert_guide_cmd(ClientData, Tcl_Interp *interp, int objc,
+                             Tcl_Obj *CONST objv[]) {
+  if (objc != 3) {
+    Tcl_WrongNumArgs(interp, objc, objv,
+                     "Usage : sca::convert_guide in_file out_file");
+    return TCL_ERROR;
+  }
+  const char *in_file = Tcl_GetStringFromObj(objv[1], nullptr);
+  const char *out_file = Tcl_GetStringFromObj(objv[2], nullptr);
+  return sca::Context::ctx()->convertGuide(in_file, out_file) ? TCL_ERROR : TCL_OK;
+}
+
+static int write_def_cmd(ClientData, Tcl_Interp *interp, int objc,
+                         Tcl_Obj *CONST objv[]) {
+  bool routes = objc == 3 && std::strcmp(Tcl_GetString(objv[1]), "-routes") == 0;
+  if (objc != 2 && !routes) {
+    Tcl_WrongNumArgs(interp, objc, objv,
+                     "Usage : sca::write_def [-routes] def_file");
+    return TCL_ERROR;
+  }
+  const char *def_file = Tcl_GetStringFromObj(objv[objc - 1], nullptr);
+  return sca::Context::ctx()->writeDef(def_file, routes) ? TCL_ERROR : TCL_OK;
+}
+
+static int write_spef_cmd(ClientData, Tcl_Interp *interp, int objc,
+                          Tcl_Obj *CONST objv[]) {
+  const char *usage =
+      "Usage : sca::write_spef [-corner corner] [-gzip] spef_file";
+  const char *corner = "";
+  bool gzip = false;
+  for (int i = 1; i < objc - 1; i++) {
+    const char *opt = Tcl_GetString(objv[i]);
+    if (std::strcmp(opt, "-corner") == 0 && i + 2 < objc) {
+      corner = Tcl_GetString(objv[++i]);
+    } else if (std::strcmp(opt, "-gzip") == 0) {
+      gzip = true;
+    } else {
+      Tcl_WrongNumArgs(interp, objc, objv, usage);
+      return TCL_ERROR;
+    }
+  }
+  if (objc < 2) {
+    Tcl_WrongNumArgs(interp, objc, objv, usage);
+    return TCL_ERROR;
+  }
+  const char *spef_file = Tcl_GetStringFromObj(objv[objc - 1], nullptr);
+  return sca::Context::ctx()->writeSpef(spef_file, corner, gzip) ? TCL_ERROR
+                                                                 : TCL_OK;
+}
+
+static int write_snapshot_cmd(ClientData, Tcl_Interp *interp, int objc,
+                              Tcl_Obj *CONST objv[]) {
+  bool routes = objc == 3 && std::strcmp(Tcl_GetString(objv[1]), "-routes") == 0;
+  if (objc != 2 && !routes) {
+    Tcl_WrongNumArgs(interp, objc, objv,
+                     "Usage : sca::write_snapshot [-routes] snapshot_file");
+    return TCL_ERROR;
+  }
+  const char *snapshot_file = Tcl_GetStringFromObj(objv[objc - 1], nullptr);
+  return sca::Context::ctx()->writeSnapshot(snapshot_file, routes) ? TCL_ERROR
+                                                                   : TCL_OK;
+}
+
+static int read_snapshot_cmd(ClientData, Tcl_Interp *interp, int objc,
+                             Tcl_Obj *CONST objv[]) {
   if (objc != 2) {
-    Tcl_WrongNumArgs(interp, objc, objv, "Usage : sca::write_guide guide_file"); return TCL_ERROR;
+    Tcl_WrongNumArgs(interp, objc, objv,
+                     "Usage : sca::read_snapshot snapshot_file");
+    return TCL_ERROR;
   }
-  const char *guide_file = Tcl_GetStringFromObj(objv[1], nullptr);
-  return sca::Context::ctx()->writeGuide(guide_file) ? TCL_OK : TCL_ERROR;
+  const char *snapshot_file = Tcl_GetStringFromObj(objv[1], nullptr);
+  return sca::Context::ctx()->readSnapshot(snapshot_file) ? TCL_ERROR : TCL_OK;
 }
 
 static int write_slack_cmd(ClientData, Tcl_Interp *interp, int objc,
@@ -80,12 +194,41 @@ static int write_slack_cmd(ClientData, Tcl_Interp *interp, int objc,
     Tcl_WrongNumArgs(interp, objc, objv, "Usage : sca::write_slack slack_file"); return TCL_ERROR;
   }
   const char *slack_file = Tcl_GetStringFromObj(objv[1], nullptr);
-  return sca::Context::ctx()->writeSlack(slack_file) ? TCL_OK : TCL_ERROR;
+  return sca::Context::ctx()->writeSlack(slack_file) ? TCL_ERROR : TCL_OK;
+}
+
+static int get_slacks_cmd(ClientData, Tcl_Interp *interp, int objc,
+                          Tcl_Obj *CONST objv[]) {
+  bool binary = objc == 2 && std::strcmp(Tcl_GetString(objv[1]), "-binary") == 0;
+  if (objc != 1 && !binary) {
+    Tcl_WrongNumArgs(interp, objc, objv, "Usage : sca::get_slacks [-binary]");
+    return TCL_ERROR;
+  }
+  std::vector<Net *> nets;
+  std::vector<float> slacks;
+  sca::Context::ctx()->netSlacks(nets, slacks);
+  if (binary) {
+    const unsigned char *bytes =
+        reinterpret_cast<const unsigned char *>(slacks.data());
+    int num_bytes = static_cast<int>(slacks.size() * sizeof(float));
+    Tcl_SetObjResult(interp, Tcl_NewByteArrayObj(bytes, num_bytes));
+    return TCL_OK;
+  }
+  Tcl_Obj *dict = Tcl_NewDictObj();
+  for (size_t i = 0; i < nets.size(); i++) {
+    const std::string &name = nets[i]->name();
+    Tcl_Obj *key = Tcl_NewStringObj(name.c_str(), static_cast<int>(name.size()));
+    Tcl_DictObjPut(interp, dict, key, Tcl_NewDoubleObj(slacks[i]));
+  }
+  Tcl_SetObjResult(interp, dict);
+  return TCL_OK;
 }
 
 static int set_layer_rc_cmd(ClientData, Tcl_Interp *interp, int objc,
                           Tcl_Obj *CONST objv[]) {
-  if (objc != 7) {
+  bool has_corner =
+      objc == 9 && std::strcmp(Tcl_GetString(objv[7]), "-corner") == 0;
+  if (objc != 7 && !has_corner) {
     Tcl_WrongNumArgs(interp, objc, objv, "Usage : set_layer_rc_cmd"); 
     return TCL_ERROR;
   }
@@ -95,8 +238,44 @@ static int set_layer_rc_cmd(ClientData, Tcl_Interp *interp, int objc,
   double resistance = atof(Tcl_GetString(objv[4]));
   // get capacitance
   double capacitance = atof(Tcl_GetString(objv[6]));
+  // get STA corner, the default RC is used by corners without their own
+  const char *corner = has_corner ? Tcl_GetString(objv[8]) : "";
 
-  return sca::Context::ctx()->setLayerRc(layer, resistance, capacitance) ? TCL_OK : TCL_ERROR;
+  return sca::Context::ctx()->setLayerRc(layer, resistance, capacitance, corner) ? TCL_OK : TCL_ERROR;
+}
+
+static int set_gcell_size_cmd(ClientData, Tcl_Interp *interp, int objc,
+                              Tcl_Obj *CONST objv[]) {
+  const char *usage =
+      "Usage : sca::set_gcell_size -def|-pitch dbu|-count n|-memory mb";
+  GcellSizeConfig cfg;
+  if (objc == 2 && std::strcmp(Tcl_GetString(objv[1]), "-def") == 0) {
+    cfg.mode = GcellSizeMode::Def;
+  } else if (objc == 3) {
+    const char *opt = Tcl_GetString(objv[1]);
+    double value = atof(Tcl_GetString(objv[2]));
+    if (value <= 0) {
+      Tcl_WrongNumArgs(interp, objc, objv, usage);
+      return TCL_ERROR;
+    }
+    if (std::strcmp(opt, "-pitch") == 0) {
+      cfg.mode = GcellSizeMode::Pitch;
+      cfg.pitch = static_cast<DBU>(value);
+    } else if (std::strcmp(opt, "-count") == 0) {
+      cfg.mode = GcellSizeMode::Count;
+      cfg.count = static_cast<long long>(value);
+    } else if (std::strcmp(opt, "-memory") == 0) {
+      cfg.mode = GcellSizeMode::Memory;
+      cfg.memory_mb = value;
+    } else {
+      Tcl_WrongNumArgs(interp, objc, objv, usage);
+      return TCL_ERROR;
+    }
+  } else {
+    Tcl_WrongNumArgs(interp, objc, objv, usage);
+    return TCL_ERROR;
+  }
+  return sca::Context::ctx()->setGcellSize(cfg) ? TCL_ERROR : TCL_OK;
 }
 
 static int set_wire_rc_cmd(ClientData, Tcl_Interp *interp, int objc,
@@ -109,7 +288,11 @@ static int set_wire_rc_cmd(ClientData, Tcl_Interp *interp, int objc,
   return TCL_OK;
 }
 
+// The STA thread count can change with set_thread_count at any time.
+static int staThreadCount() { return sta::Sta::sta()->threadCount(); }
+
 int Route_Init(Tcl_Interp *interp) {
+  setNumThreadsSource(staThreadCount);
   Tcl_CreateObjCommand(interp, "sca::read_lef", read_lef_cmd, nullptr, nullptr);
   Tcl_CreateObjCommand(interp, "sca::read_def", read_def_cmd, nullptr, nullptr);
   Tcl_CreateObjCommand(interp, "sca::link_design", link_design_cmd, nullptr,
@@ -124,12 +307,26 @@ int Route_Init(Tcl_Interp *interp) {
                        nullptr);
   Tcl_CreateObjCommand(interp, "sca::write_guide", write_guide_cmd, nullptr,
                        nullptr);
+  Tcl_CreateObjCommand(interp, "sca::convert_guide", convert_guide_cmd,
+                       nullptr, nullptr);
+  Tcl_CreateObjCommand(interp, "sca::write_def", write_def_cmd, nullptr,
+                       nullptr);
+  Tcl_CreateObjCommand(interp, "sca::write_spef", write_spef_cmd, nullptr,
+                       nullptr);
+  Tcl_CreateObjCommand(interp, "sca::write_snapshot", write_snapshot_cmd,
+                       nullptr, nullptr);
+  Tcl_CreateObjCommand(interp, "sca::read_snapshot", read_snapshot_cmd,
+                       nullptr, nullptr);
   Tcl_CreateObjCommand(interp, "sca::write_slack", write_slack_cmd, nullptr,
                        nullptr);
+  Tcl_CreateObjCommand(interp, "sca::get_slacks", get_slacks_cmd, nullptr,
+                       nullptr);
   Tcl_CreateObjCommand(interp, "sca::link_design", link_design_cmd, nullptr,
                        nullptr);
   Tcl_CreateObjCommand(interp, "set_layer_rc", set_layer_rc_cmd, nullptr,
                        nullptr);
+  Tcl_CreateObjCommand(interp, "sca::set_gcell_size", set_gcell_size_cmd,
+                       nullptr, nullptr);
   Tcl_CreateObjCommand(interp, "set_wire_rc", set_wire_rc_cmd, nullptr,
                        nullptr);
   return TCL_OK;
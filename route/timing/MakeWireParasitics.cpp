@@ -1,10 +1,18 @@
 #include "MakeWireParasitics.hpp"
 #include "../object/Route.hpp"
 #include "../util/log.hpp"
+#include "../util/output_buffer.hpp"
+#include "../util/parallel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
 #include <sta/Corner.hh>
+#include <sta/DcalcAnalysisPt.hh>
 #include <sta/Network.hh>
 #include <sta/PortDirection.hh>
+#include <sta/Sdc.hh>
 #include <sta/Sta.hh>
+#include <sta/Transition.hh>
 #include <sta/Units.hh>
 
 namespace sca {
@@ -23,8 +31,24 @@ static sta::PortDirection *toStaDirection(PortDirection dir) {
   return sta::PortDirection::unknown();
 }
 
+// Name of the STA object with index `idx`: `_<idx>_`.
+static std::string staName(size_t idx) {
+  std::string name = "_";
+  appendInt(name, static_cast<long long>(idx));
+  name += '_';
+  return name;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point &start) {
+  auto now = std::chrono::steady_clock::now();
+  double seconds = std::chrono::duration<double>(now - start).count();
+  start = now;
+  return seconds;
+}
+
 MakeWireParasitics::MakeWireParasitics(Design *design) {
   m_design = design;
+  auto phase_start = std::chrono::steady_clock::now();
 
   m_sta = sta::Sta::sta();
   m_sta->readNetlistBefore();
@@ -37,11 +61,13 @@ MakeWireParasitics::MakeWireParasitics(Design *design) {
       m_sta_library, m_design->name().c_str(), false, nullptr);
   Instance *top_inst = m_design->topInstance();
   Libcell *top_libcell = top_inst->libcell();
+  PortMap top_ports;
   for (int i = 0; i < top_libcell->numPorts(); i++) {
     Port *port = top_libcell->port(i);
     sta::Port *sta_port =
         m_sta_network->makePort(m_sta_top_cell, port->name().c_str());
     m_sta_network->setDirection(sta_port, toStaDirection(port->direction()));
+    top_ports.emplace(port->name(), sta_port);
   }
 
   // create top instance
@@ -49,59 +75,82 @@ MakeWireParasitics::MakeWireParasitics(Design *design) {
   m_sta->readNetlistBefore();
   m_sta_top_inst = m_sta_network->makeInstance(
       m_sta_top_cell, m_design->name().c_str(), nullptr);
+  top_inst->setStaInstance(m_sta_top_inst);
 
-  // create instances
+  // create instances connected to a net, in design order
   LOG_TRACE("create sta insts");
-  std::set<Instance *> net_insts;
-  for (int i = 0; i < m_design->numNets(); i++) {
-    Net *net = m_design->net(i);
-    for (int j = 0; j < net->numPins(); j++) {
-      Pin *pin = net->pin(j);
-      if (pin->instance() != design->topInstance())
-        net_insts.insert(pin->instance());
+  std::vector<Instance *> net_insts;
+  net_insts.reserve(static_cast<size_t>(m_design->numInstances()));
+  for (int i = 0; i < m_design->numInstances(); i++) {
+    Instance *inst = m_design->instance(i);
+    for (int j = 0; j < inst->numPins(); j++) {
+      if (inst->pin(j)->net()) {
+        net_insts.push_back(inst);
+        break;
+      }
     }
   }
-  std::map<Instance *, std::pair<sta::Instance *, sta::LibertyCell *>> inst_map;
-  {
-    int i = 0;
-    for (Instance *inst : net_insts) {
-      inst->setStaName("_" + std::to_string(i) + "_");
-      Libcell *libcell = inst->libcell();
-      sta::LibertyCell *sta_liberty_cell =
-          m_sta_network->findLibertyCell(libcell->name().c_str());
-      sta::Instance *sta_inst = m_sta_network->makeInstance(
-          sta_liberty_cell, inst->staName().c_str(), m_sta_top_inst);
-      inst_map.emplace(inst, std::make_pair(sta_inst, sta_liberty_cell));
-      i++;
-    }
+  std::unordered_map<const Libcell *, LibcellPorts> libcell_ports;
+  std::vector<const LibcellPorts *> inst_ports;
+  inst_ports.reserve(net_insts.size());
+  for (size_t i = 0; i < net_insts.size(); i++) {
+    Instance *inst = net_insts[i];
+    inst->setStaName(staName(i));
+    auto [it, inserted] = libcell_ports.try_emplace(inst->libcell());
+    if (inserted)
+      makeLibcellPorts(inst->libcell(), it->second);
+    inst->setStaInstance(m_sta_network->makeInstance(
+        it->second.sta_cell, inst->staName().c_str(), m_sta_top_inst));
+    inst_ports.push_back(&it->second);
   }
+  double inst_seconds = secondsSince(phase_start);
 
   // create nets
   LOG_TRACE("create sta nets");
   for (int i = 0; i < m_design->numNets(); i++) {
     Net *net = m_design->net(i);
-    net->setStaName("_" + std::to_string(i) + "_");
-    sta::Net *sta_net =
-        m_sta_network->makeNet(net->staName().c_str(), m_sta_top_inst);
-    for (int j = 0; j < net->numPins(); j++) {
-      Pin *pin = net->pin(j);
-      if (pin->instance() == m_design->topInstance()) {
-        sta::Port *sta_port =
-            m_sta_network->findPort(m_sta_top_cell, pin->name().c_str());
-        ASSERT(sta_port, "");
-        sta::Pin *sta_pin =
-            m_sta_network->makePin(m_sta_top_inst, sta_port, nullptr);
-        m_sta_network->makeTerm(sta_pin, sta_net);
-      } else {
-        Instance *inst = pin->instance();
-        auto [sta_inst, sta_liberty_cell] = inst_map.at(inst);
-        sta::Cell *sta_cell = reinterpret_cast<sta::Cell *>(sta_liberty_cell);
-        sta::Port *sta_port =
-            m_sta_network->findPort(sta_cell, pin->name().c_str());
-        m_sta_network->makePin(sta_inst, sta_port, sta_net);
-      }
+    net->setStaName(staName(static_cast<size_t>(i)));
+    net->setStaNet(
+        m_sta_network->makeNet(net->staName().c_str(), m_sta_top_inst));
+  }
+  double net_seconds = secondsSince(phase_start);
+
+  // create pins, instance by instance with the ports of its libcell at hand
+  LOG_TRACE("create sta pins");
+  size_t num_pins = 0;
+  for (int i = 0; i < top_inst->numPins(); i++) {
+    Pin *pin = top_inst->pin(i);
+    if (pin->net() == nullptr)
+      continue;
+    auto it = top_ports.find(pin->name());
+    ASSERT(it != top_ports.end(), "");
+    sta::Pin *sta_pin =
+        m_sta_network->makePin(m_sta_top_inst, it->second, nullptr);
+    m_sta_network->makeTerm(sta_pin, pin->net()->staNet());
+    pin->setStaPin(sta_pin);
+    num_pins++;
+  }
+  for (size_t i = 0; i < net_insts.size(); i++) {
+    Instance *inst = net_insts[i];
+    const LibcellPorts &ports = *inst_ports[i];
+    for (int j = 0; j < inst->numPins(); j++) {
+      Pin *pin = inst->pin(j);
+      if (pin->net() == nullptr)
+        continue;
+      auto it = ports.ports.find(pin->name());
+      sta::Port *sta_port =
+          it != ports.ports.end()
+              ? it->second
+              : m_sta_network->findPort(ports.sta_cell, pin->name().c_str());
+      pin->setStaPin(m_sta_network->makePin(inst->staInstance(), sta_port,
+                                            pin->net()->staNet()));
+      num_pins++;
     }
   }
+  double pin_seconds = secondsSince(phase_start);
+  LOG_INFO("sta network: %zu instances %.3f s, %d nets %.3f s, %zu pins %.3f s",
+           net_insts.size(), inst_seconds, m_design->numNets(), net_seconds,
+           num_pins, pin_seconds);
 
   LOG_TRACE("acquire arcDelayCalc and parasitics");
   m_parasitics = m_sta->parasitics();
@@ -109,108 +158,289 @@ MakeWireParasitics::MakeWireParasitics(Design *design) {
   clearParasitics();
 }
 
+void MakeWireParasitics::makeLibcellPorts(Libcell *libcell,
+                                          LibcellPorts &ports) const {
+  sta::LibertyCell *sta_liberty_cell =
+      m_sta_network->findLibertyCell(libcell->name().c_str());
+  ASSERT(sta_liberty_cell, "libcell %s not found in liberty",
+         libcell->name().c_str());
+  ports.sta_cell = reinterpret_cast<sta::Cell *>(sta_liberty_cell);
+  for (int i = 0; i < libcell->numPorts(); i++) {
+    const std::string &name = libcell->port(i)->name();
+    ports.ports.emplace(name,
+                        m_sta_network->findPort(ports.sta_cell, name.c_str()));
+  }
+}
+
 MakeWireParasitics::~MakeWireParasitics() { m_sta_network->clear(); }
 
+// Number of nets per batch of the RC tree pipeline.
+static constexpr size_t kRcTreeBatchSize = 4096;
+
 void MakeWireParasitics::estimateParasitcs(Net *net) {
-  sta::Net *sta_net = m_sta_network->findNet(m_sta_network->topInstance(),
-                                             net->staName().c_str());
+  estimateParasitcs(std::vector<Net *>{net});
+}
+
+int MakeWireParasitics::estimateParasitcs(const std::vector<Net *> &nets) {
+  if (nets.empty())
+    return 0;
+  updateCorners();
+  if (!m_parasitics->haveParasitics()) { // e.g. after remove_parasitics
+    for (int i = 0; i < m_design->numNets(); i++)
+      m_design->net(i)->setParasiticsHash(0);
+  }
+  std::vector<Net *> changed_nets;
+  std::vector<RcTree> batches[2];
+  buildRcTrees(nets, 0, batches[0]);
+  for (size_t begin = 0, b = 0; begin < nets.size();
+       begin += kRcTreeBatchSize, b ^= 1) {
+    // build the next batch while this one is committed
+    size_t next_begin = begin + kRcTreeBatchSize;
+    std::thread next;
+    if (next_begin < nets.size()) {
+      if (numThreads() > 1)
+        next = std::thread([&, next_begin, b]() {
+          buildRcTrees(nets, next_begin, batches[b ^ 1]);
+        });
+      else
+        buildRcTrees(nets, next_begin, batches[b ^ 1]);
+    }
+    const std::vector<RcTree> &batch = batches[b];
+    for (size_t i = 0; i < batch.size(); i++) {
+      Net *net = nets[begin + i];
+      if (batch[i].hash == net->parasiticsHash())
+        continue;
+      commitRcTree(net, batch[i]);
+      net->setParasiticsHash(batch[i].hash);
+      changed_nets.push_back(net);
+    }
+    if (next.joinable())
+      next.join();
+  }
+  invalidateDelays(changed_nets);
+  return static_cast<int>(changed_nets.size());
+}
+
+// Analysis points shared by corners or by min and max are filled once, and
+// OpenSTA reduces one network into both analysis points of a corner.
+void MakeWireParasitics::updateCorners() {
+  if ((m_sta->corners()->count() > 1) != m_per_corner_aps)
+    clearParasitics();
+  const Technology *tech = m_design->technology();
+  std::vector<ParasiticsCorner> corners;
+  std::vector<int> rc_corners;
+  for (sta::Corner *corner : m_sta->corners()->corners()) {
+    int rc_corner = tech->findRcCorner(corner->name());
+    auto it = std::find(rc_corners.begin(), rc_corners.end(), rc_corner);
+    int tree_corner = static_cast<int>(it - rc_corners.begin());
+    if (it == rc_corners.end())
+      rc_corners.push_back(rc_corner);
+    const sta::MinMax *max = sta::MinMax::max(), *min = sta::MinMax::min();
+    sta::ParasiticAnalysisPt *max_ap = corner->findParasiticAnalysisPt(max);
+    sta::ParasiticAnalysisPt *min_ap = corner->findParasiticAnalysisPt(min);
+    auto known = [&corners](const sta::ParasiticAnalysisPt *ap) {
+      return std::any_of(
+          corners.begin(), corners.end(),
+          [ap](const ParasiticsCorner &c) { return c.ap == ap; });
+    };
+    bool new_max = !known(max_ap);
+    bool new_min = min_ap != max_ap && !known(min_ap);
+    if (new_max)
+      corners.push_back({corner, max, max_ap,
+                         new_min || min_ap == max_ap ? sta::MinMaxAll::all()
+                                                     : max->asMinMaxAll(),
+                         tree_corner});
+    if (new_min)
+      corners.push_back({corner, min, min_ap,
+                         new_max ? nullptr : min->asMinMaxAll(),
+                         tree_corner});
+  }
+  bool changed = rc_corners != m_rc_corners ||
+                 corners.size() != m_corners.size() ||
+                 !std::equal(corners.begin(), corners.end(), m_corners.begin(),
+                             [](const ParasiticsCorner &a,
+                                const ParasiticsCorner &b) {
+                               return a.ap == b.ap &&
+                                      a.reduce_min_max == b.reduce_min_max &&
+                                      a.tree_corner == b.tree_corner;
+                             });
+  m_corners = std::move(corners);
+  m_rc_corners = std::move(rc_corners);
+  if (changed) {
+    for (int i = 0; i < m_design->numNets(); i++)
+      m_design->net(i)->setParasiticsHash(0);
+  }
+}
 
-  sta::Corner *corner = m_sta->corners()->corners()[0];
-  sta::MinMax *min_max = sta::MinMax::max();
-  sta::ParasiticAnalysisPt *ap = corner->findParasiticAnalysisPt(min_max);
-  m_parasitics->deleteReducedParasitics(sta_net, ap);
-  sta::Parasitic *parasitic =
-      m_parasitics->makeParasiticNetwork(sta_net, false, ap);
+// Invalidating pin by pin only pays off when few nets changed.
+void MakeWireParasitics::invalidateDelays(const std::vector<Net *> &nets) {
+  if (nets.size() > static_cast<size_t>(m_design->numNets()) / 8) {
+    m_sta->delaysInvalid();
+    return;
+  }
+  for (Net *net : nets) {
+    for (int i = 0; i < net->numPins(); i++)
+      m_sta->delaysInvalidFromFanin(net->pin(i)->staPin());
+  }
+}
 
-  m_node_map.clear();
-  m_resistor_id = 1;
-  makeRouteParasitics(net, sta_net, parasitic);
-  makeParasiticsToPins(net, sta_net, parasitic);
+void MakeWireParasitics::buildRcTrees(const std::vector<Net *> &nets,
+                                      size_t begin,
+                                      std::vector<RcTree> &trees) const {
+  size_t end = std::min(nets.size(), begin + kRcTreeBatchSize);
+  trees.resize(end - begin);
+  int num_ranges =
+      std::max(1, std::min(numThreads(), static_cast<int>(end - begin)));
+  parallelFor(0, num_ranges, [&](int r) {
+    RcTreeBuilder builder(m_design, m_rc_corners);
+    size_t first = begin + (end - begin) * static_cast<size_t>(r) /
+                               static_cast<size_t>(num_ranges);
+    size_t last = begin + (end - begin) * static_cast<size_t>(r + 1) /
+                              static_cast<size_t>(num_ranges);
+    for (size_t i = first; i < last; i++)
+      builder.build(nets[i], trees[i - begin]);
+  });
+}
 
-  m_arc_delay_calc->reduceParasitic(parasitic, sta_net, corner,
-                                    sta::MinMaxAll::all());
-  m_parasitics->deleteParasiticNetworks(sta_net);
+void MakeWireParasitics::commitRcTree(Net *net, const RcTree &tree) {
+  if (m_reduce_mode == ReduceMode::Direct)
+    commitPiElmore(net, tree);
+  else
+    commitNetwork(net, tree);
+}
+
+// One OpenSTA network per corner, reduced by OpenSTA.
+void MakeWireParasitics::commitNetwork(Net *net, const RcTree &tree) {
+  sta::Net *sta_net = net->staNet();
+  for (const ParasiticsCorner &pc : m_corners)
+    m_parasitics->deleteReducedParasitics(sta_net, pc.ap);
+  for (const ParasiticsCorner &pc : m_corners) {
+    if (pc.reduce_min_max == nullptr)
+      continue;
+    sta::Parasitic *parasitic =
+        m_parasitics->makeParasiticNetwork(sta_net, false, pc.ap);
+
+    // <net>:<sub_node>
+    m_nodes.clear();
+    for (int i = 0; i < tree.numNodes(); i++) {
+      sta::ParasiticNode *node = m_parasitics->ensureParasiticNode(
+          parasitic, sta_net, i, m_sta_network);
+      m_parasitics->incrCap(node, tree.cap(i, pc.tree_corner));
+      m_nodes.push_back(node);
+    }
+    size_t resistor_id = 1;
+    for (size_t r = 0; r < tree.resistors.size(); r++) {
+      const RcTree::Resistor &resistor = tree.resistors[r];
+      m_parasitics->makeResistor(
+          parasitic, resistor_id++,
+          tree.resistance(static_cast<int>(r), pc.tree_corner),
+          m_nodes[static_cast<size_t>(resistor.node1)],
+          m_nodes[static_cast<size_t>(resistor.node2)]);
+    }
+    for (int i = 0; i < net->numPins(); i++) {
+      sta::ParasiticNode *pin_node = m_parasitics->ensureParasiticNode(
+          parasitic, net->pin(i)->staPin(), m_sta_network);
+      sta::ParasiticNode *route_node =
+          m_nodes[static_cast<size_t>(tree.pin_nodes[static_cast<size_t>(i)])];
+      m_parasitics->makeResistor(parasitic, resistor_id++, 0.0, pin_node,
+                                 route_node);
+    }
+
+    m_arc_delay_calc->reduceParasitic(parasitic, sta_net, pc.corner,
+                                      pc.reduce_min_max);
+    m_parasitics->deleteParasiticNetworks(sta_net);
+  }
+}
+
+// Same reduction as OpenSTA does, once per driver, analysis point and
+// transition; the tree is traversed once per driver. Pin capacitances are
+// taken from the SDC like OpenSTA does for networks without pin caps.
+void MakeWireParasitics::commitPiElmore(Net *net, const RcTree &tree) {
+  sta::Net *sta_net = net->staNet();
+  for (const ParasiticsCorner &pc : m_corners)
+    m_parasitics->deleteReducedParasitics(sta_net, pc.ap);
+
+  sta::Sdc *sdc = m_sta->sdc();
+  auto pin_cap = [&](const sta::Pin *sta_pin, const sta::RiseFall *rf,
+                     const sta::Corner *corner,
+                     const sta::DcalcAnalysisPt *dcalc_ap) {
+    sta::Port *port = m_sta_network->port(sta_pin);
+    if (m_sta_network->libertyPort(port))
+      return sdc->pinCapacitance(sta_pin, rf, dcalc_ap->operatingConditions(),
+                                 corner, dcalc_ap->constraintMinMax());
+    if (m_sta_network->isTopLevelPort(sta_pin))
+      return sdc->portExtCap(port, rf, corner, dcalc_ap->constraintMinMax());
+    return 0.f;
+  };
+  for (int d = 0; d < net->numPins(); d++) {
+    const sta::Pin *drvr_pin = net->pin(d)->staPin();
+    if (!m_sta_network->isDriver(drvr_pin))
+      continue;
+    m_reducer.traverse(tree, d);
+    for (const ParasiticsCorner &pc : m_corners) {
+      const sta::DcalcAnalysisPt *dcalc_ap =
+          pc.corner->findDcalcAnalysisPt(pc.min_max);
+      for (const sta::RiseFall *rf : sta::RiseFall::range()) {
+        m_pin_caps.clear();
+        for (int i = 0; i < net->numPins(); i++)
+          m_pin_caps.push_back(
+              pin_cap(net->pin(i)->staPin(), rf, pc.corner, dcalc_ap));
+        m_reducer.reduce(pc.tree_corner, m_pin_caps, m_pi_elmore);
+        sta::Parasitic *pi_elmore =
+            m_parasitics->makePiElmore(drvr_pin, rf, pc.ap, m_pi_elmore.c2,
+                                       m_pi_elmore.rpi, m_pi_elmore.c1);
+        for (int i = 0; i < net->numPins(); i++) {
+          const sta::Pin *load_pin = net->pin(i)->staPin();
+          float elmore = m_pi_elmore.elmores[static_cast<size_t>(i)];
+          if (i != d && elmore >= 0.f && m_sta_network->isLoad(load_pin))
+            m_parasitics->setElmore(pi_elmore, load_pin, elmore);
+        }
+      }
+    }
+  }
+}
+
+void MakeWireParasitics::setReduceMode(ReduceMode mode) {
+  if (mode == m_reduce_mode)
+    return;
+  m_reduce_mode = mode;
+  for (int i = 0; i < m_design->numNets(); i++)
+    m_design->net(i)->setParasiticsHash(0);
 }
 
 void MakeWireParasitics::clearParasitics() {
   // Remove any existing parasitics.
   m_sta->deleteParasitics();
-  // Make separate parasitics for each corner.
-  m_sta->setParasiticAnalysisPts(false);
+  for (int i = 0; i < m_design->numNets(); i++)
+    m_design->net(i)->setParasiticsHash(0);
+  // Make separate parasitics for each corner, shared ones as always with a
+  // single corner.
+  m_per_corner_aps = m_sta->corners()->count() > 1;
+  m_sta->setParasiticAnalysisPts(m_per_corner_aps);
 }
 
 float MakeWireParasitics::getNetSlack(Net *net) {
-  sta::Net *sta_net = m_sta_network->findNet(m_sta_network->topInstance(),
-                                             net->staName().c_str());
+  sta::Net *sta_net = net->staNet();
   float slack = m_sta->netSlack(sta_net, sta::MinMax::max());
   return slack;
 }
 
-void MakeWireParasitics::makeRouteParasitics(Net *net, sta::Net *sta_net,
-                                             sta::Parasitic *parasitic) {
-  if (net->routingTree() == nullptr || net->routingTree()->children.size() == 0)
-    return;
-  GRTreeNode::preorder(
-      net->routingTree(), [&](std::shared_ptr<GRTreeNode> tree) {
-        for (const auto &child : tree->children) {
-          const auto [init_layer, final_layer] =
-              std::minmax(tree->layerIdx, child->layerIdx);
-          const auto [init_x, final_x] = std::minmax(tree->x, child->x);
-          const auto [init_y, final_y] = std::minmax(tree->y, child->y);
-          PointOnLayerT<int> pt1(init_layer, init_x, init_y);
-          PointOnLayerT<int> pt2(final_layer, final_x, final_y);
-          // <net>:<sub_node>
-          sta::ParasiticNode *n1 = ensureParasiticNode(pt1, parasitic, sta_net);
-          sta::ParasiticNode *n2 = ensureParasiticNode(pt2, parasitic, sta_net);
-
-          float res = 0.f, cap = 0.f;
-          Technology *tech = m_design->technology();
-          Grid *grid = m_design->grid();
-          if (init_layer == final_layer) { // wire
-            double dbu = m_design->dbu();
-            DBU wire_length_dbu = grid->wireLength(*tree, *child);
-            double wire_length = (wire_length_dbu / dbu) * 1e-6;
-            cap += tech->layerCap(init_layer) * wire_length;
-            res += tech->layerRes(init_layer) * wire_length;
-          } else { // via
-            for (int l = init_layer; l < final_layer; l++)
-              res += tech->cutLayerRes(l);
-          }
-          m_parasitics->incrCap(n1, 0.5f * cap);
-          m_parasitics->makeResistor(parasitic, m_resistor_id++, res, n1, n2);
-          m_parasitics->incrCap(n2, 0.5f * cap);
-        }
-      });
-}
-
-void MakeWireParasitics::makeParasiticsToPins(Net *net, sta::Net *sta_net,
-                                              sta::Parasitic *parasitic) {
-  for (int i = 0; i < net->numPins(); i++) {
-    Pin *pin = net->pin(i);
-    Instance *inst = pin->instance();
-    sta::Instance *sta_inst =
-        inst == m_design->topInstance()
-            ? m_sta_top_inst
-            : m_sta_network->findInstanceRelative(m_sta_top_inst,
-                                                  inst->staName().c_str());
-    sta::Pin *sta_pin = m_sta_network->findPin(sta_inst, pin->name().c_str());
-    sta::ParasiticNode *n1 =
-        m_parasitics->ensureParasiticNode(parasitic, sta_pin, m_sta_network);
-    sta::ParasiticNode *n2 =
-        ensureParasiticNode(pin->position(), parasitic, sta_net);
-    m_parasitics->makeResistor(parasitic, m_resistor_id++, 0.0, n1, n2);
-  }
-}
-
-sta::ParasiticNode *MakeWireParasitics::ensureParasiticNode(
-    const PointOnLayerT<int> &pt, sta::Parasitic *parasitic, sta::Net *net) {
-  if (m_node_map.find(pt) == m_node_map.end()) {
-    int id = static_cast<int>(m_node_map.size());
-    sta::ParasiticNode *node =
-        m_parasitics->ensureParasiticNode(parasitic, net, id, m_sta_network);
-    m_node_map.emplace(pt, node);
-  }
-  return m_node_map.at(pt);
+// Sta::netSlack is the worst slack of the load pins of the net, found here
+// from the cached pins instead of walking the network for every net.
+void MakeWireParasitics::getNetSlacks(const std::vector<Net *> &nets,
+                                      std::vector<float> &slacks) {
+  m_sta->findRequireds();
+  slacks.resize(nets.size());
+  for (size_t i = 0; i < nets.size(); i++) {
+    Net *net = nets[i];
+    float slack = sta::MinMax::min()->initValue();
+    for (int j = 0; j < net->numPins(); j++) {
+      const sta::Pin *sta_pin = net->pin(j)->staPin();
+      if (m_sta_network->isLoad(sta_pin))
+        slack = std::min(slack, m_sta->pinSlack(sta_pin, sta::MinMax::max()));
+    }
+    slacks[i] = slack;
+  }
 }
 
 } // namespace sca
@@ -1,33 +1,78 @@
 #pragma once
 
 #include "../object/Design.hpp"
-#include <map>
+#include "RcTree.hpp"
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 #include <sta/Parasitics.hh>
 #include <sta/Sta.hh>
 
 namespace sca {
 
+// How RC trees become the reduced parasitics used by delay calculation.
+enum class ReduceMode {
+  Sta,    // build an OpenSTA parasitic network and let OpenSTA reduce it
+  Direct, // compute pi models and Elmore delays from the RC tree
+};
+
 class MakeWireParasitics {
 public:
   MakeWireParasitics(Design *design);
   ~MakeWireParasitics();
 
   void estimateParasitcs(Net *net);
+  // Same for many nets: RC trees are built in batches by worker threads while
+  // the previous batch is committed to OpenSTA. Nets whose RC tree did not
+  // change since the last call are skipped and only the delays around the
+  // others are invalidated. Returns the number of nets updated.
+  // Only the RC trees are compared: after pin or port caps change (set_load,
+  // liberty) or parasitics are read or removed from Tcl, clearParasitics has
+  // to be called first. All nets are updated anyway once OpenSTA has no
+  // parasitics at all.
+  // Each STA corner uses the RC corner of the same name, or the default one,
+  // and one tree holds the values of all RC corners in use.
+  int estimateParasitcs(const std::vector<Net *> &nets);
+  // Remove all parasitics, the next estimate updates every net.
   void clearParasitics();
+  // Changing the mode makes the next estimate update every net.
+  void setReduceMode(ReduceMode mode);
+  ReduceMode reduceMode() const { return m_reduce_mode; }
   // Return the Slack of a given net
   float getNetSlack(Net *net);
+  // Same for many nets, with one update of the required times for all.
+  void getNetSlacks(const std::vector<Net *> &nets, std::vector<float> &slacks);
 
   sta::Instance *staTopInstance() const { return m_sta_top_inst; }
 
 private:
-  void makeRouteParasitics(Net *net, sta::Net *sta_net,
-                           sta::Parasitic *parasitic);
-  void makeParasiticsToPins(Net *net, sta::Net *sta_net,
-                            sta::Parasitic *parasitic);
+  // sta::Port of each port of a libcell, looked up once per libcell
+  using PortMap = std::unordered_map<std::string_view, sta::Port *>;
+  struct LibcellPorts {
+    sta::Cell *sta_cell;
+    PortMap ports;
+  };
+  void makeLibcellPorts(Libcell *libcell, LibcellPorts &ports) const;
+
+  // A parasitic analysis point and the values of the RC tree that fill it.
+  struct ParasiticsCorner {
+    sta::Corner *corner;
+    const sta::MinMax *min_max;
+    sta::ParasiticAnalysisPt *ap;
+    // analysis points OpenSTA reduces the network of this one into, null if
+    // another entry's network already covers this one
+    const sta::MinMaxAll *reduce_min_max;
+    int tree_corner; // index in m_rc_corners
+  };
+  void updateCorners();
 
-  sta::ParasiticNode *ensureParasiticNode(const PointOnLayerT<int> &pt,
-                                          sta::Parasitic *parasitic,
-                                          sta::Net *net);
+  void buildRcTrees(const std::vector<Net *> &nets, size_t begin,
+                    std::vector<RcTree> &trees) const;
+  // OpenSTA parasitics are not thread safe, trees are committed one by one.
+  void commitRcTree(Net *net, const RcTree &tree);
+  void commitNetwork(Net *net, const RcTree &tree);
+  void commitPiElmore(Net *net, const RcTree &tree);
+  void invalidateDelays(const std::vector<Net *> &nets);
 
   Design *m_design;
   sta::Sta *m_sta;
@@ -38,9 +83,14 @@ private:
   sta::Parasitics *m_parasitics;
   sta::ArcDelayCalc *m_arc_delay_calc;
 
-  using NodeRoutePtMap = std::map<PointOnLayerT<int>, sta::ParasiticNode *>;
-  NodeRoutePtMap m_node_map;
-  size_t m_resistor_id;
+  ReduceMode m_reduce_mode = ReduceMode::Sta;
+  std::vector<ParasiticsCorner> m_corners;
+  bool m_per_corner_aps = false;
+  std::vector<int> m_rc_corners; // Technology RC corner of each tree corner
+  std::vector<sta::ParasiticNode *> m_nodes; // by RC tree node id
+  PiElmoreReducer m_reducer;
+  PiElmore m_pi_elmore;
+  std::vector<float> m_pin_caps;
 };
 
 } // namespace sca
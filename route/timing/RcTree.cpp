@@ -0,0 +1,249 @@
+#include "RcTree.hpp"
+#include "../object/Route.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace sca {
+
+void RcTree::clear(int num_corners) {
+  this->num_corners = num_corners;
+  caps.clear();
+  resistors.clear();
+  res.clear();
+  pin_nodes.clear();
+  hash = 0;
+}
+
+void RcTree::updateHash() {
+  uint64_t h = 0xcbf29ce484222325ull;
+  auto mix = [&h](uint64_t v) {
+    h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+  };
+  auto mix_floats = [&mix](const std::vector<float> &values) {
+    mix(values.size());
+    for (float value : values) {
+      uint32_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      mix(bits);
+    }
+  };
+  mix(static_cast<uint64_t>(num_corners));
+  mix_floats(caps);
+  mix_floats(res);
+  for (const Resistor &r : resistors)
+    mix(static_cast<uint64_t>(r.node1) << 32 | static_cast<uint32_t>(r.node2));
+  for (int node : pin_nodes)
+    mix(static_cast<uint64_t>(node));
+  hash = h ? h : 1;
+}
+
+// The geometry of each edge is found once and then priced per corner.
+void RcTreeBuilder::build(const Net *net, RcTree &tree) {
+  int num_corners = static_cast<int>(m_rc_corners.size());
+  tree.clear(num_corners);
+  m_node_map.clear();
+  const Technology *tech = m_design->technology();
+  const Grid *grid = m_design->grid();
+  double dbu = m_design->dbu();
+  std::shared_ptr<GRTreeNode> route = net->routingTree();
+  if (route && route->children.size() > 0) {
+    GRTreeNode::preorder(
+        route, [&](std::shared_ptr<GRTreeNode> node) {
+          for (const auto &child : node->children) {
+            const auto [init_layer, final_layer] =
+                std::minmax(node->layerIdx, child->layerIdx);
+            const auto [init_x, final_x] = std::minmax(node->x, child->x);
+            const auto [init_y, final_y] = std::minmax(node->y, child->y);
+            int n1 = ensureNode(PointOnLayerT<int>(init_layer, init_x, init_y),
+                                tree);
+            int n2 = ensureNode(
+                PointOnLayerT<int>(final_layer, final_x, final_y), tree);
+
+            tree.resistors.push_back({n1, n2});
+            double wire_length = 0.;
+            if (init_layer == final_layer) { // wire
+              DBU wire_length_dbu = grid->wireLength(*node, *child);
+              wire_length = (wire_length_dbu / dbu) * 1e-6;
+            }
+            for (int c = 0; c < num_corners; c++) {
+              int rc_corner = m_rc_corners[static_cast<size_t>(c)];
+              float res = 0.f, cap = 0.f;
+              if (init_layer == final_layer) { // wire
+                cap += tech->layerCap(init_layer, rc_corner) * wire_length;
+                res += tech->layerRes(init_layer, rc_corner) * wire_length;
+              } else { // via
+                for (int l = init_layer; l < final_layer; l++)
+                  res += tech->cutLayerRes(l);
+              }
+              tree.caps[static_cast<size_t>(n1 * num_corners + c)] +=
+                  0.5f * cap;
+              tree.res.push_back(res);
+              tree.caps[static_cast<size_t>(n2 * num_corners + c)] +=
+                  0.5f * cap;
+            }
+          }
+        });
+  }
+  for (int i = 0; i < net->numPins(); i++)
+    tree.pin_nodes.push_back(ensureNode(net->pin(i)->position(), tree));
+  tree.updateHash();
+}
+
+int RcTreeBuilder::ensureNode(const PointOnLayerT<int> &pt, RcTree &tree) {
+  int id = m_node_map.ensure(pt, tree.numNodes());
+  if (id == tree.numNodes())
+    tree.caps.resize(tree.caps.size() + static_cast<size_t>(tree.num_corners));
+  return id;
+}
+
+void NodeIdMap::clear() {
+  m_size = 0;
+  if (++m_stamp == 0) { // wrapped around, old tags could match again
+    for (Slot &slot : m_slots)
+      slot.stamp = 0;
+    m_stamp = 1;
+  }
+}
+
+// 16 bits of layer, 24 bits of each gcell coordinate
+uint64_t NodeIdMap::pack(const PointOnLayerT<int> &pt) {
+  return static_cast<uint64_t>(static_cast<uint16_t>(pt.layerIdx)) << 48 |
+         static_cast<uint64_t>(static_cast<uint32_t>(pt.x) & 0xffffff) << 24 |
+         static_cast<uint64_t>(static_cast<uint32_t>(pt.y) & 0xffffff);
+}
+
+int NodeIdMap::ensure(const PointOnLayerT<int> &pt, int new_id) {
+  if (2 * (m_size + 1) > m_slots.size())
+    grow();
+  uint64_t key = pack(pt);
+  size_t mask = m_slots.size() - 1;
+  for (size_t i = (key * 0x9e3779b97f4a7c15ull) >> 32 & mask;;
+       i = (i + 1) & mask) {
+    Slot &slot = m_slots[i];
+    if (slot.stamp != m_stamp) {
+      slot = {key, m_stamp, new_id};
+      m_size++;
+      return new_id;
+    }
+    if (slot.key == key)
+      return slot.id;
+  }
+}
+
+void NodeIdMap::grow() {
+  std::vector<Slot> old_slots;
+  old_slots.swap(m_slots);
+  m_slots.assign(std::max<size_t>(64, 2 * old_slots.size()), Slot{0, 0, 0});
+  size_t mask = m_slots.size() - 1;
+  for (const Slot &old : old_slots) {
+    if (old.stamp != m_stamp)
+      continue;
+    size_t i = (old.key * 0x9e3779b97f4a7c15ull) >> 32 & mask;
+    while (m_slots[i].stamp == m_stamp)
+      i = (i + 1) & mask;
+    m_slots[i] = old;
+  }
+}
+
+void PiElmoreReducer::traverse(const RcTree &tree, int drvr_pin) {
+  m_tree = &tree;
+  size_t num_route_nodes = static_cast<size_t>(tree.numNodes());
+  size_t num_nodes = num_route_nodes + tree.pin_nodes.size();
+  auto add_edges = [&](auto &&add) {
+    for (size_t r = 0; r < tree.resistors.size(); r++)
+      add(tree.resistors[r].node1, tree.resistors[r].node2,
+          static_cast<int>(r));
+    for (size_t i = 0; i < tree.pin_nodes.size(); i++)
+      add(static_cast<int>(num_route_nodes + i), tree.pin_nodes[i], -1);
+  };
+  m_adj_begin.assign(num_nodes + 1, 0);
+  add_edges([&](int n1, int n2, int) {
+    m_adj_begin[static_cast<size_t>(n1) + 1]++;
+    m_adj_begin[static_cast<size_t>(n2) + 1]++;
+  });
+  for (size_t i = 0; i < num_nodes; i++)
+    m_adj_begin[i + 1] += m_adj_begin[i];
+  m_adj.resize(static_cast<size_t>(m_adj_begin[num_nodes]));
+  m_fill.assign(m_adj_begin.begin(), m_adj_begin.end() - 1);
+  add_edges([&](int n1, int n2, int r) {
+    m_adj[static_cast<size_t>(m_fill[static_cast<size_t>(n1)]++)] = {n2, r};
+    m_adj[static_cast<size_t>(m_fill[static_cast<size_t>(n2)]++)] = {n1, r};
+  });
+
+  // loops and duplicate resistors are ignored, as OpenSTA does
+  int root = static_cast<int>(num_route_nodes) + drvr_pin;
+  m_parent.assign(num_nodes, -1);
+  m_parent_resistor.assign(num_nodes, -1);
+  m_order.clear();
+  m_order.push_back(root);
+  m_parent[static_cast<size_t>(root)] = root;
+  for (size_t k = 0; k < m_order.size(); k++) {
+    int node = m_order[k];
+    for (int e = m_adj_begin[static_cast<size_t>(node)];
+         e < m_adj_begin[static_cast<size_t>(node) + 1]; e++) {
+      const Edge &edge = m_adj[static_cast<size_t>(e)];
+      if (m_parent[static_cast<size_t>(edge.node)] != -1)
+        continue;
+      m_parent[static_cast<size_t>(edge.node)] = node;
+      m_parent_resistor[static_cast<size_t>(edge.node)] = edge.resistor;
+      m_order.push_back(edge.node);
+    }
+  }
+}
+
+double PiElmoreReducer::parentRes(size_t node, int corner) const {
+  int resistor = m_parent_resistor[node];
+  return resistor < 0 ? 0.0 : m_tree->resistance(resistor, corner);
+}
+
+void PiElmoreReducer::reduce(int corner, const std::vector<float> &pin_caps,
+                             PiElmore &pi_elmore) {
+  size_t num_route_nodes = static_cast<size_t>(m_tree->numNodes());
+  size_t num_nodes = m_parent.size();
+  m_y1.resize(num_nodes);
+  m_y2.assign(num_nodes, 0.0);
+  m_y3.assign(num_nodes, 0.0);
+  m_elmore.resize(num_nodes);
+  for (int node : m_order) {
+    size_t n = static_cast<size_t>(node);
+    m_y1[n] = n < num_route_nodes ? m_tree->cap(node, corner)
+                                  : pin_caps[n - num_route_nodes];
+  }
+  // admittance moments, children before their parent
+  for (size_t k = m_order.size() - 1; k > 0; k--) {
+    size_t n = static_cast<size_t>(m_order[k]);
+    size_t p = static_cast<size_t>(m_parent[n]);
+    double r = parentRes(n, corner);
+    double y1 = m_y1[n], y2 = m_y2[n], y3 = m_y3[n];
+    m_y1[p] += y1;
+    m_y2[p] += y2 - r * y1 * y1;
+    m_y3[p] += y3 - 2 * r * y1 * y2 + r * r * y1 * y1 * y1;
+  }
+  size_t root = static_cast<size_t>(m_order[0]);
+  double y1 = m_y1[root], y2 = m_y2[root], y3 = m_y3[root];
+  if (y2 == 0.0 && y3 == 0.0) { // capacitive load
+    pi_elmore.c1 = static_cast<float>(y1);
+    pi_elmore.c2 = 0.f;
+    pi_elmore.rpi = 0.f;
+  } else {
+    pi_elmore.c1 = static_cast<float>(y2 * y2 / y3);
+    pi_elmore.c2 = static_cast<float>(y1 - y2 * y2 / y3);
+    pi_elmore.rpi = static_cast<float>(-y3 * y3 / (y2 * y2 * y2));
+  }
+
+  // Elmore delay, the downstream cap of a node is its first moment
+  m_elmore[root] = 0.0;
+  for (size_t k = 1; k < m_order.size(); k++) {
+    size_t n = static_cast<size_t>(m_order[k]);
+    m_elmore[n] = m_elmore[static_cast<size_t>(m_parent[n])] +
+                  parentRes(n, corner) * m_y1[n];
+  }
+  pi_elmore.elmores.assign(pin_caps.size(), -1.f);
+  for (size_t i = 0; i < pin_caps.size(); i++) {
+    size_t n = num_route_nodes + i;
+    if (m_parent[n] != -1)
+      pi_elmore.elmores[i] = static_cast<float>(m_elmore[n]);
+  }
+}
+
+} // namespace sca
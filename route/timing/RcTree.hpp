@@ -0,0 +1,112 @@
+#pragma once
+
+#include "../object/Design.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace sca {
+
+// Flat RC network of one routed net, independent of OpenSTA so that it can be
+// built by worker threads. Node ids follow the order in which route points
+// are first seen, resistors follow the order of the tree edges. Values are
+// kept for several corners, which share the topology.
+struct RcTree {
+  struct Resistor {
+    int node1, node2;
+  };
+  int num_corners = 1;
+  std::vector<float> caps; // by node id, then corner
+  std::vector<Resistor> resistors;
+  std::vector<float> res;     // by resistor, then corner
+  std::vector<int> pin_nodes; // node each pin of the net connects to
+  uint64_t hash = 0;          // of all of the above, never 0 once built
+
+  int numNodes() const { return static_cast<int>(caps.size()) / num_corners; }
+  float cap(int node, int corner) const {
+    return caps[static_cast<size_t>(node * num_corners + corner)];
+  }
+  float resistance(int resistor, int corner) const {
+    return res[static_cast<size_t>(resistor * num_corners + corner)];
+  }
+  void clear(int num_corners);
+  void updateHash();
+};
+
+// Open addressing map from route points to node ids. Entries are tagged with
+// the net they belong to, so clearing is free and the table is only ever
+// allocated when it grows.
+class NodeIdMap {
+public:
+  void clear();
+  // id of `pt`, `new_id` if it was not in the map yet
+  int ensure(const PointOnLayerT<int> &pt, int new_id);
+
+private:
+  static uint64_t pack(const PointOnLayerT<int> &pt);
+  void grow();
+
+  struct Slot {
+    uint64_t key;
+    uint32_t stamp;
+    int id;
+  };
+  std::vector<Slot> m_slots; // power of two size
+  uint32_t m_stamp = 1;
+  size_t m_size = 0;
+};
+
+// Turns routing trees into RC trees, corner i of a tree with the layer RC
+// of Technology RC corner `rc_corners[i]`. A builder keeps its node map
+// between nets, use one per thread.
+class RcTreeBuilder {
+public:
+  RcTreeBuilder(const Design *design, const std::vector<int> &rc_corners = {0})
+      : m_design(design), m_rc_corners(rc_corners) {}
+
+  void build(const Net *net, RcTree &tree);
+
+private:
+  int ensureNode(const PointOnLayerT<int> &pt, RcTree &tree);
+
+  const Design *m_design;
+  std::vector<int> m_rc_corners;
+  NodeIdMap m_node_map;
+};
+
+// Reduced model of an RC tree as seen from one driver pin: pi model
+// (c2 - rpi - c1) and Elmore delay to every other pin.
+struct PiElmore {
+  float c2, rpi, c1;
+  std::vector<float> elmores; // by pin, negative if not connected
+};
+
+// Reduces RC trees the way OpenSTA reduces parasitic networks, without
+// building one. Pins are nodes of their own, connected to their route node
+// with 0 ohm. Keeps its arrays between trees, use one per thread.
+class PiElmoreReducer {
+public:
+  // Order the nodes of `tree` from pin `drvr_pin` outwards.
+  void traverse(const RcTree &tree, int drvr_pin);
+  // Reduce corner `corner` of the traversed tree with `pin_caps` added to
+  // the pin nodes.
+  void reduce(int corner, const std::vector<float> &pin_caps,
+              PiElmore &pi_elmore);
+
+private:
+  struct Edge {
+    int node;
+    int resistor; // -1 for pins
+  };
+  double parentRes(size_t node, int corner) const;
+
+  const RcTree *m_tree = nullptr;
+  std::vector<int> m_adj_begin;
+  std::vector<Edge> m_adj;
+  std::vector<int> m_fill;
+  std::vector<int> m_order;       // breadth first from the driver
+  std::vector<int> m_parent;      // -1 if not reached
+  std::vector<int> m_parent_resistor;
+  std::vector<double> m_y1, m_y2, m_y3, m_elmore;
+};
+
+} // namespace sca
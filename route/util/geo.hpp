@@ -5,6 +5,7 @@
 #include <cmath>
 #include <iostream>
 #include <limits>
+#include <type_traits>
 #include <vector>
 
 namespace sca {
@@ -421,6 +422,58 @@ void SlicePolygons(std::vector<BoxT<T>> &boxes, int sliceDir) {
   MergeRects(boxes, sweepDir);
 }
 
+// Split the polygon of the n vertices (xs[i], ys[i]) into rectangles, one
+// slab between consecutive vertex y coordinates at a time. The edges crossing
+// a slab alternately enter and leave the polygon; a diagonal edge counts with
+// its whole extent in the slab, so only 45 degree corners are
+// over-approximated. Integer coordinates are rounded outwards.
+template <typename T>
+void SplitPolygon(const T *xs, const T *ys, int n,
+                  std::vector<BoxT<T>> &boxes) {
+  std::vector<T> locs(ys, ys + n);
+  std::sort(locs.begin(), locs.end());
+  locs.erase(std::unique(locs.begin(), locs.end()), locs.end());
+  struct Crossing {
+    double mid_x;
+    T lx, hx;
+  };
+  auto round_down = [](double x) {
+    if constexpr (std::is_integral_v<T>)
+      return static_cast<T>(std::floor(x));
+    else
+      return static_cast<T>(x);
+  };
+  auto round_up = [](double x) {
+    if constexpr (std::is_integral_v<T>)
+      return static_cast<T>(std::ceil(x));
+    else
+      return static_cast<T>(x);
+  };
+  std::vector<Crossing> crossings;
+  for (size_t s = 0; s + 1 < locs.size(); s++) {
+    T y0 = locs[s], y1 = locs[s + 1];
+    crossings.clear();
+    for (int i = 0; i < n; i++) {
+      T xa = xs[i], ya = ys[i];
+      T xb = xs[(i + 1) % n], yb = ys[(i + 1) % n];
+      if (std::min(ya, yb) > y0 || std::max(ya, yb) < y1)
+        continue; // horizontal or outside of the slab
+      auto x_at = [&](T y) {
+        return xa + static_cast<double>(xb - xa) * (y - ya) / (yb - ya);
+      };
+      double x0 = x_at(y0), x1 = x_at(y1);
+      crossings.push_back({(x0 + x1) / 2, round_down(std::min(x0, x1)),
+                           round_up(std::max(x0, x1))});
+    }
+    std::sort(crossings.begin(), crossings.end(),
+              [](const Crossing &a, const Crossing &b) {
+                return a.mid_x < b.mid_x;
+              });
+    for (size_t k = 0; k + 1 < crossings.size(); k += 2)
+      boxes.emplace_back(crossings[k].lx, y0, crossings[k + 1].hx, y1);
+  }
+}
+
 template <typename T> class SegmentT : public BoxT<T> {
 public:
   using BoxT<T>::BoxT;
@@ -0,0 +1,104 @@
+#include "gzip_reader.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <zlib.h>
+
+namespace sca {
+
+GzipReader::GzipReader(const std::string &path)
+    : m_blocks(kNumBlocks, std::vector<char>(kBlockSize)),
+      m_block_sizes(kNumBlocks, 0) {
+  gzFile file = gzopen(path.c_str(), "rb");
+  if (file == nullptr)
+    return;
+  gzbuffer(file, 1 << 17);
+  m_file = file;
+  m_thread = std::thread(&GzipReader::inflate, this);
+}
+
+GzipReader::~GzipReader() {
+  if (m_file == nullptr)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  m_thread.join();
+  gzclose(static_cast<gzFile>(m_file));
+}
+
+bool GzipReader::isGzip(const std::string &path) {
+  FILE *file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+  unsigned char magic[2] = {0, 0};
+  size_t n = std::fread(magic, 1, 2, file);
+  std::fclose(file);
+  return n == 2 && magic[0] == 0x1f && magic[1] == 0x8b;
+}
+
+void GzipReader::inflate() {
+  gzFile file = static_cast<gzFile>(m_file);
+  for (size_t tail = 0;; tail = (tail + 1) % kNumBlocks) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [&] { return m_filled < kNumBlocks || m_stop; });
+      if (m_stop)
+        return;
+    }
+    // the tail block is not visible to the consumer until it is filled
+    int n = gzread(file, m_blocks[tail].data(),
+                   static_cast<unsigned>(kBlockSize));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (n <= 0) {
+      m_failed = n < 0 || !gzeof(file);
+      m_done = true;
+      m_cv.notify_all();
+      return;
+    }
+    m_block_sizes[tail] = static_cast<size_t>(n);
+    m_filled++;
+    m_cv.notify_all();
+  }
+}
+
+size_t GzipReader::read(char *buffer, size_t size) {
+  if (m_file == nullptr)
+    return 0;
+  size_t copied = 0;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (copied < size) {
+    m_cv.wait(lock, [&] { return m_filled > 0 || m_done; });
+    if (m_filled == 0)
+      break;
+    // The head block is not written while it is filled, so the copy can
+    // run unlocked.
+    lock.unlock();
+    size_t n = std::min(size - copied, m_block_sizes[m_head] - m_offset);
+    std::memcpy(buffer + copied, m_blocks[m_head].data() + m_offset, n);
+    copied += n;
+    m_offset += n;
+    lock.lock();
+    if (m_offset == m_block_sizes[m_head]) {
+      m_head = (m_head + 1) % kNumBlocks;
+      m_offset = 0;
+      m_filled--;
+      m_cv.notify_all();
+    }
+  }
+  return copied;
+}
+
+GzipStreamBuf::int_type GzipStreamBuf::underflow() {
+  if (gptr() < egptr())
+    return traits_type::to_int_type(*gptr());
+  size_t n = m_reader->read(m_buffer, sizeof(m_buffer));
+  if (n == 0)
+    return traits_type::eof();
+  setg(m_buffer, m_buffer, m_buffer + n);
+  return traits_type::to_int_type(*gptr());
+}
+
+} // namespace sca
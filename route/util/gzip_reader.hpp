@@ -0,0 +1,65 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sca {
+
+// Reads a gzip compressed file. A background thread inflates it into a
+// small ring of blocks ahead of the consumer, so that decompression
+// overlaps with parsing. Files that are not compressed are passed through.
+class GzipReader {
+public:
+  explicit GzipReader(const std::string &path);
+  ~GzipReader();
+  GzipReader(const GzipReader &) = delete;
+  GzipReader &operator=(const GzipReader &) = delete;
+
+  // Whether the file starts with the gzip magic bytes.
+  static bool isGzip(const std::string &path);
+
+  bool isOpen() const { return m_file != nullptr; }
+  // Copy up to `size` bytes of the inflated data into `buffer`. Returns the
+  // number of bytes copied, 0 at the end of the data.
+  size_t read(char *buffer, size_t size);
+  // Whether the data was cut short by a corrupt or truncated file.
+  bool failed() const { return m_failed; }
+
+private:
+  void inflate();
+
+  static constexpr size_t kNumBlocks = 4;
+  static constexpr size_t kBlockSize = size_t(1) << 20;
+
+  void *m_file = nullptr; // gzFile
+  std::vector<std::vector<char>> m_blocks;
+  std::vector<size_t> m_block_sizes;
+  size_t m_head = 0;   // block being consumed
+  size_t m_filled = 0; // number of blocks ready to consume
+  size_t m_offset = 0; // consumed bytes of the head block
+  bool m_done = false;
+  bool m_stop = false;
+  bool m_failed = false;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::thread m_thread;
+};
+
+// std::streambuf on top of a GzipReader, for the line based readers.
+class GzipStreamBuf : public std::streambuf {
+public:
+  explicit GzipStreamBuf(GzipReader *reader) : m_reader(reader) {}
+
+protected:
+  int_type underflow() override;
+
+private:
+  GzipReader *m_reader;
+  char m_buffer[1 << 16];
+};
+
+} // namespace sca
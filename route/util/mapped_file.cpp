@@ -0,0 +1,31 @@
+#include "mapped_file.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sca {
+
+MappedFile::MappedFile(const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    size_t size = static_cast<size_t>(st.st_size);
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      madvise(addr, size, MADV_SEQUENTIAL);
+      m_data = static_cast<char *>(addr);
+      m_size = size;
+    }
+  }
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (m_data)
+    munmap(m_data, m_size);
+}
+
+} // namespace sca
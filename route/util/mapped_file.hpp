@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace sca {
+
+// Read-only view of a whole file, mapped copy-on-write so that the LEF/DEF
+// lexers may push characters back into it. The kernel is told the file is
+// read sequentially, which enables aggressive read-ahead.
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &path);
+  ~MappedFile();
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  // False if the file could not be mapped, e.g. it is empty or a pipe.
+  bool isMapped() const { return m_data != nullptr; }
+  char *data() const { return m_data; }
+  size_t size() const { return m_size; }
+
+private:
+  char *m_data = nullptr;
+  size_t m_size = 0;
+};
+
+} // namespace sca
@@ -0,0 +1,91 @@
+#include "output_buffer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace sca {
+
+// Compression level of appendGzip: the writers compress on every thread, so
+// speed matters more than the last few percent of size.
+static constexpr int kGzipLevel = 3;
+
+void appendGzip(std::string &out, std::string_view data) {
+  z_stream stream{};
+  // 16 + MAX_WBITS: gzip header and trailer instead of zlib ones
+  deflateInit2(&stream, kGzipLevel, Z_DEFLATED, 16 + MAX_WBITS, 8,
+               Z_DEFAULT_STRATEGY);
+  size_t offset = out.size();
+  out.resize(offset + deflateBound(&stream, static_cast<uLong>(data.size())));
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef *>(&out[offset]);
+  stream.avail_out = static_cast<uInt>(out.size() - offset);
+  deflate(&stream, Z_FINISH);
+  out.resize(offset + stream.total_out);
+  deflateEnd(&stream);
+}
+
+OutputFile::OutputFile(const std::string &path) {
+  m_fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  m_ok = m_fd >= 0;
+}
+
+OutputFile::~OutputFile() { close(); }
+
+bool OutputFile::write(const std::vector<std::string_view> &buffers) {
+  if (m_fd < 0)
+    return false;
+  std::vector<iovec> iov;
+  for (const auto &buffer : buffers) {
+    if (!buffer.empty())
+      iov.push_back({const_cast<char *>(buffer.data()), buffer.size()});
+  }
+  size_t first = 0;
+  while (m_ok && first < iov.size()) {
+    int count = static_cast<int>(std::min<size_t>(iov.size() - first, IOV_MAX));
+    ssize_t written = writev(m_fd, &iov[first], count);
+    if (written < 0) {
+      m_ok = errno == EINTR;
+      continue;
+    }
+    // skip what was written, a short write may stop inside a buffer
+    size_t left = static_cast<size_t>(written);
+    while (first < iov.size() && left >= iov[first].iov_len)
+      left -= iov[first++].iov_len;
+    if (left > 0) {
+      iov[first].iov_base = static_cast<char *>(iov[first].iov_base) + left;
+      iov[first].iov_len -= left;
+    }
+  }
+  return m_ok;
+}
+
+bool OutputFile::write(const std::vector<std::string> &buffers) {
+  return write(std::vector<std::string_view>(buffers.begin(), buffers.end()));
+}
+
+bool OutputFile::close() {
+  if (m_fd >= 0) {
+    m_ok = ::close(m_fd) == 0 && m_ok;
+    m_fd = -1;
+  }
+  return m_ok;
+}
+
+bool writeBuffers(const std::string &path,
+                  const std::vector<std::string_view> &buffers) {
+  OutputFile file(path);
+  return file.write(buffers) && file.close();
+}
+
+bool writeBuffers(const std::string &path,
+                  const std::vector<std::string> &buffers) {
+  return writeBuffers(
+      path, std::vector<std::string_view>(buffers.begin(), buffers.end()));
+}
+
+} // namespace sca
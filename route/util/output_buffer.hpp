@@ -0,0 +1,64 @@
+#pragma once
+
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sca {
+
+// Helpers for writers that format text into memory, typically one buffer per
+// thread, and write all of it at once.
+
+inline void appendInt(std::string &out, long long value) {
+  char digits[24];
+  auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+  out.append(digits, static_cast<size_t>(end - digits));
+}
+
+// Same as printf("%.*g", precision, value).
+inline void appendFloat(std::string &out, float value, int precision) {
+  char digits[32];
+  auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value,
+                                 std::chars_format::general, precision);
+  out.append(digits, static_cast<size_t>(end - digits));
+}
+
+inline void appendWord(std::string &out, std::string_view word) {
+  out.append(word.data(), word.size());
+}
+
+// Compress `data` as one gzip member and append it to `out`. Members can be
+// concatenated into a gzip file, so buffers can be compressed independently.
+void appendGzip(std::string &out, std::string_view data);
+
+// File written in chunks, for writers that do not hold all of the output in
+// memory. Each write passes its buffers in order with as few system calls as
+// possible.
+class OutputFile {
+public:
+  explicit OutputFile(const std::string &path);
+  ~OutputFile();
+  OutputFile(const OutputFile &) = delete;
+  OutputFile &operator=(const OutputFile &) = delete;
+
+  bool isOpen() const { return m_fd >= 0; }
+  // Returns false if this or an earlier write failed.
+  bool write(const std::vector<std::string_view> &buffers);
+  bool write(const std::vector<std::string> &buffers);
+  // Returns false if any write failed or the file could not be closed.
+  bool close();
+
+private:
+  int m_fd = -1;
+  bool m_ok = true;
+};
+
+// Write the buffers to `path` in order with as few system calls as possible.
+// Returns false if the file could not be created or written.
+bool writeBuffers(const std::string &path,
+                  const std::vector<std::string_view> &buffers);
+bool writeBuffers(const std::string &path,
+                  const std::vector<std::string> &buffers);
+
+} // namespace sca
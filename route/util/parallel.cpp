@@ -0,0 +1,21 @@
+#include "parallel.hpp"
+
+namespace sca {
+
+static int s_num_threads = 1;
+static int (*s_num_threads_source)() = nullptr;
+
+int numThreads() {
+  if (s_num_threads_source)
+    return std::max(1, s_num_threads_source());
+  return s_num_threads;
+}
+
+void setNumThreads(int num_threads) {
+  s_num_threads = std::max(1, num_threads);
+  s_num_threads_source = nullptr;
+}
+
+void setNumThreadsSource(int (*source)()) { s_num_threads_source = source; }
+
+} // namespace sca
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace sca {
+
+// Number of worker threads used by the route library. It is the last count
+// set, or what `source` returns on every call once one is set, so that it
+// follows the thread count of the STA it is linked into.
+int numThreads();
+void setNumThreads(int num_threads);
+void setNumThreadsSource(int (*source)());
+
+// Run func(i) for every i in [begin, end). Indices are handed out
+// dynamically, so func must not depend on the order of execution.
+template <class Func> void parallelFor(int begin, int end, Func &&func) {
+  int num_threads = std::min(numThreads(), end - begin);
+  if (num_threads <= 1) {
+    for (int i = begin; i < end; i++)
+      func(i);
+    return;
+  }
+  std::atomic<int> next(begin);
+  auto work = [&]() {
+    for (int i = next++; i < end; i = next++)
+      func(i);
+  };
+  std::vector<std::thread> workers;
+  for (int t = 1; t < num_threads; t++)
+    workers.emplace_back(work);
+  work();
+  for (auto &worker : workers)
+    worker.join();
+}
+
+} // namespace sca
@@ -0,0 +1,48 @@
+# Guide round trip on gcd: the routing trees read back from a written guide,
+# text or binary, must be written the same way again. A via lost on the way,
+# for example one going down from a parent to a pin, changes the trees.
+# Exits with status 1 if the guides differ.
+
+proc read_file {path} {
+  set f [open $path rb]
+  set data [read $f]
+  close $f
+  return $data
+}
+
+sca::read_lef "./Nangate45/Nangate45.lef"
+sca::read_def "./gcd_nangate45_new.def"
+sca::read_guide "./gcd_nangate45_new.guide"
+
+file mkdir results
+set text results/round_trip.guide
+set binary results/round_trip.bguide
+set failed 0
+
+sca::write_guide $text
+sca::read_guide $text
+sca::write_guide $text.again
+if {[read_file $text] ne [read_file $text.again]} {
+  puts "text guide changes when read back"
+  set failed 1
+}
+
+sca::write_guide -binary $binary
+sca::convert_guide $binary $binary.txt
+if {[read_file $text] ne [read_file $binary.txt]} {
+  puts "binary guide converts to a different text guide"
+  set failed 1
+}
+sca::read_guide $binary
+sca::write_guide $binary.again
+if {[read_file $text] ne [read_file $binary.again]} {
+  puts "binary guide changes when read back"
+  set failed 1
+}
+
+if {$failed} {
+  puts "FAIL"
+  exit 1
+}
+puts "PASS"
+exit
@@ -0,0 +1,58 @@
+# Net slacks with the parasitics reduced by OpenSTA and by
+# `sca::estimate_parasitics -reduce direct` on gcd. Exits with status 1 if
+# they differ by more than 1 ps.
+
+proc set_all_input_output_delays {{clk_period_factor .2}} {
+  set clk [lindex [all_clocks] 0]
+  set period [get_property $clk period]
+  set delay [expr $period * $clk_period_factor]
+  set_input_delay $delay -clock $clk [delete_from_list [all_inputs] [all_clocks]]
+  set_output_delay $delay -clock $clk [delete_from_list [all_outputs] [all_clocks]]
+}
+
+proc setup_sta_env {} {
+  create_clock [get_ports clk] -name core_clock -period 0.4850
+  set_all_input_output_delays
+  set_propagated_clock [all_clocks]
+}
+
+# Largest slack difference between two sca::get_slacks dicts and its net.
+proc max_slack_difference {slacks1 slacks2} {
+  set max_diff 0
+  set max_net ""
+  dict for {net slack} $slacks1 {
+    set other [dict get $slacks2 $net]
+    # unconstrained nets have infinite slacks in both
+    if {$slack == $other} {
+      continue
+    }
+    set diff [expr abs($slack - $other)]
+    if {$diff > $max_diff} {
+      set max_diff $diff
+      set max_net $net
+    }
+  }
+  return [list $max_diff $max_net]
+}
+
+read_liberty "./Nangate45/Nangate45_typ.lib"
+sca::read_lef "./Nangate45/Nangate45.lef"
+sca::read_def "./gcd_nangate45_new.def"
+sca::link_design gcd
+sca::read_guide "./gcd_nangate45_new.guide"
+source ./Nangate45/setRC.tcl
+setup_sta_env
+
+sca::estimate_parasitics -reduce sta
+set sta_slacks [sca::get_slacks]
+sca::estimate_parasitics -reduce direct
+set direct_slacks [sca::get_slacks]
+
+lassign [max_slack_difference $sta_slacks $direct_slacks] max_diff max_net
+puts "nets [dict size $sta_slacks] max slack difference $max_diff ($max_net)"
+if {$max_diff > 1e-12} {
+  puts "FAIL"
+  exit 1
+}
+puts "PASS"
+exit